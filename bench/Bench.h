@@ -0,0 +1,40 @@
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// minimal timing helpers shared by the benchmarks in this directory
+
+class BenchTimer {
+public:
+    BenchTimer() : start(std::chrono::steady_clock::now()) {}
+    double elapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    void reset() { start = std::chrono::steady_clock::now(); }
+private:
+    std::chrono::steady_clock::time_point start;
+};
+
+inline void benchHeader(const std::string& name)
+{
+    std::cout << "\n=== " << name << " ===" << std::endl;
+}
+
+// keeps the optimizer from discarding benchmarked work
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// each benchmark lives in its own translation unit
+void runPaletteStorageBench();
+void runJobSystemBench();
+void runGridNoiseBench();
+void runTerrainRegionCacheBench();
+void runBiomeSamplerBench();
+void runLightEngineBench();
+void runLightPropagationBench();
+void runMeshingBench();
@@ -0,0 +1,35 @@
+#include <functional>
+#include <map>
+
+#include "Bench.h"
+
+// usage: meincraft-bench [name...], runs every benchmark when no name is given
+int main(int argc, char** argv)
+{
+    const std::map<std::string, std::function<void()>> benches {
+            {"palette", runPaletteStorageBench},
+            {"jobs", runJobSystemBench},
+            {"noise", runGridNoiseBench},
+            {"regions", runTerrainRegionCacheBench},
+            {"biomes", runBiomeSamplerBench},
+            {"light", runLightEngineBench},
+            {"propagation", runLightPropagationBench},
+            {"meshing", runMeshingBench},
+    };
+
+    if (argc == 1) {
+        for (auto& [name, bench] : benches)
+            bench();
+        return 0;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        auto it = benches.find(argv[i]);
+        if (it == benches.end()) {
+            std::cout << "unknown benchmark: " << argv[i] << std::endl;
+            return 1;
+        }
+        it->second();
+    }
+    return 0;
+}
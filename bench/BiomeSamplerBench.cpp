@@ -0,0 +1,49 @@
+#include <vector>
+
+#include "Bench.h"
+#include "BiomeSampler.h"
+
+// per-column biome sampling vs the coarse interpolated lattice, over a large area so both biomes occur
+void runBiomeSamplerBench()
+{
+    benchHeader("BiomeSampler coarse lattice vs per-column");
+
+    // distinct seeds: with the generator's (equal) seeds every column is grass and any sampler would match
+    BiomeSampler sampler(5271998, 5271999);
+    // 129x129 chunks, every 8th chunk of a ~33000 block square (biome fields vary over thousands of blocks)
+    const int radius = 64;
+    const int stride = 8;
+    std::vector<glm::vec3> chunks;
+    for (int zOff = -radius; zOff <= radius; zOff++)
+        for (int xOff = -radius; xOff <= radius; xOff++)
+            chunks.emplace_back(xOff * stride * CHUNK_WIDTH, 0, zOff * stride * CHUNK_WIDTH);
+
+    std::vector<BiomeSampler::BiomeMap> exact(chunks.size()), coarse(chunks.size());
+
+    BenchTimer exactTimer;
+    for (size_t i = 0; i < chunks.size(); i++)
+        sampler.sampleExact(chunks[i], exact[i]);
+    double exactMs = exactTimer.elapsedMs();
+    doNotOptimize(exact.data());
+
+    BenchTimer coarseTimer;
+    for (size_t i = 0; i < chunks.size(); i++)
+        sampler.sampleCoarse(chunks[i], coarse[i]);
+    double coarseMs = coarseTimer.elapsedMs();
+    doNotOptimize(coarse.data());
+
+    long columns = 0, matching = 0, sand = 0;
+    for (size_t i = 0; i < chunks.size(); i++)
+        for (int col = 0; col < CHUNK_WIDTH * CHUNK_WIDTH; col++)
+        {
+            columns++;
+            matching += exact[i][col] == coarse[i][col];
+            sand += exact[i][col] == SandBiome;
+        }
+
+    std::cout << chunks.size() << " chunks (" << 100.0 * sand / columns << "% sand columns)" << std::endl;
+    std::cout << "per-column: " << exactMs << " ms" << std::endl;
+    std::cout << "coarse:     " << coarseMs << " ms (" << exactMs / coarseMs << "x)" << std::endl;
+    std::cout << "matching columns: " << matching << " / " << columns << " ("
+              << 100.0 * matching / columns << "%)" << std::endl;
+}
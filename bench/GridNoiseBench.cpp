@@ -0,0 +1,64 @@
+#include <cstring>
+#include <vector>
+
+#include "Bench.h"
+#include "Chunk.h"
+#include "GridNoise.h"
+
+// per-point FastNoiseLite::GetNoise vs one GridNoise tile per chunk, using the terrain base settings (16 octave FBm)
+void runGridNoiseBench()
+{
+    benchHeader("GridNoise tile vs FastNoiseLite::GetNoise");
+
+    const int seed = 5271998;
+    FastNoiseLite scalarNoise;
+    scalarNoise.SetSeed(seed);
+    scalarNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    scalarNoise.SetFractalType(FastNoiseLite::FractalType_FBm);
+    scalarNoise.SetFrequency(0.00522f);
+    scalarNoise.SetFractalOctaves(16);
+    scalarNoise.SetFractalLacunarity(1.0f);
+
+    GridNoise gridNoise;
+    gridNoise.setSeed(seed);
+    gridNoise.setFractalType(FastNoiseLite::FractalType_FBm);
+    gridNoise.setFrequency(0.00522f);
+    gridNoise.setFractalOctaves(16);
+    gridNoise.setFractalLacunarity(1.0f);
+
+    // same 21x21 square ChunkLoaderSystem keeps loaded around the player
+    const int loadDistance = 10;
+    const int tileSize = CHUNK_WIDTH * CHUNK_WIDTH;
+    const int chunkCount = (2 * loadDistance + 1) * (2 * loadDistance + 1);
+    std::vector<float> scalarOut(chunkCount * tileSize), gridOut(chunkCount * tileSize);
+
+    BenchTimer scalarTimer;
+    int chunk = 0;
+    for (int zOff = -loadDistance; zOff <= loadDistance; zOff++)
+        for (int xOff = -loadDistance; xOff <= loadDistance; xOff++, chunk++)
+            for (int z = 0; z < CHUNK_WIDTH; z++)
+                for (int x = 0; x < CHUNK_WIDTH; x++)
+                    scalarOut[chunk * tileSize + x + z * CHUNK_WIDTH] =
+                            scalarNoise.GetNoise((float) (x + xOff * CHUNK_WIDTH), (float) (z + zOff * CHUNK_WIDTH));
+    double scalarMs = scalarTimer.elapsedMs();
+    doNotOptimize(scalarOut.data());
+
+    BenchTimer gridTimer;
+    chunk = 0;
+    for (int zOff = -loadDistance; zOff <= loadDistance; zOff++)
+        for (int xOff = -loadDistance; xOff <= loadDistance; xOff++, chunk++)
+            gridNoise.getNoiseTile(xOff * CHUNK_WIDTH, zOff * CHUNK_WIDTH, CHUNK_WIDTH, CHUNK_WIDTH,
+                                   gridOut.data() + chunk * tileSize);
+    double gridMs = gridTimer.elapsedMs();
+    doNotOptimize(gridOut.data());
+
+    // terrain must not change: compare bit patterns, not values
+    int mismatches = 0;
+    for (size_t i = 0; i < scalarOut.size(); i++)
+        mismatches += std::memcmp(&scalarOut[i], &gridOut[i], sizeof(float)) != 0;
+
+    std::cout << chunkCount << " chunk heightmaps" << std::endl;
+    std::cout << "GetNoise per point: " << scalarMs << " ms" << std::endl;
+    std::cout << "GridNoise tiles:    " << gridMs << " ms (" << scalarMs / gridMs << "x)" << std::endl;
+    std::cout << "bit mismatches: " << mismatches << " / " << scalarOut.size() << std::endl;
+}
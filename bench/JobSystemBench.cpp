@@ -0,0 +1,91 @@
+#include <thread>
+#include <vector>
+
+#include "Bench.h"
+#include "ChunkGenerator.h"
+#include "JobSystem.h"
+
+namespace {
+
+struct FrameStats {
+    double totalMs = 0.0;
+    double worstFrameMs = 0.0;
+    int chunks = 0;
+};
+
+// simulates the loader: one startup frame filling the 21x21 window, then frames streaming in one new row each
+template <typename GenerateBatch>
+FrameStats simulateFrames(GenerateBatch generateBatch)
+{
+    ChunkGenerator generator(5271998);
+
+    const int loadDistance = 10;
+    const int streamingFrames = 30;
+    FrameStats stats;
+
+    auto runFrame = [&](const std::vector<glm::vec3>& positions) {
+        BenchTimer timer;
+        std::vector<std::unique_ptr<ChunkPayload>> payloads = generateBatch(generator, positions);
+        double frameMs = timer.elapsedMs();
+        doNotOptimize(payloads);
+
+        stats.totalMs += frameMs;
+        stats.worstFrameMs = std::max(stats.worstFrameMs, frameMs);
+        stats.chunks += static_cast<int>(positions.size());
+    };
+
+    std::vector<glm::vec3> startup;
+    for (int z = -loadDistance; z <= loadDistance; z++)
+        for (int x = -loadDistance; x <= loadDistance; x++)
+            startup.emplace_back(x * CHUNK_WIDTH, 0, z * CHUNK_WIDTH);
+    runFrame(startup);
+
+    for (int frame = 1; frame <= streamingFrames; frame++) {
+        std::vector<glm::vec3> row;
+        for (int z = -loadDistance; z <= loadDistance; z++)
+            row.emplace_back((loadDistance + frame) * CHUNK_WIDTH, 0, z * CHUNK_WIDTH);
+        runFrame(row);
+    }
+
+    return stats;
+}
+
+void report(const char* name, const FrameStats& stats)
+{
+    std::cout << name << ": " << stats.chunks / (stats.totalMs / 1000.0) << " chunks/s, worst frame "
+              << stats.worstFrameMs << " ms" << std::endl;
+}
+
+}
+
+void runJobSystemBench()
+{
+    benchHeader("JobSystem vs thread-per-chunk generation");
+
+    FrameStats threadStats = simulateFrames([](ChunkGenerator& generator, const std::vector<glm::vec3>& positions) {
+        std::vector<std::unique_ptr<ChunkPayload>> payloads(positions.size());
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < positions.size(); i++)
+            threads.emplace_back([&generator, &payloads, &positions, i]() {
+                payloads[i] = generator.generateChunkData(positions[i]);
+            });
+        for (std::thread& t : threads)
+            t.join();
+        return payloads;
+    });
+    report("thread per chunk", threadStats);
+
+    JobSystem jobSystem;
+    FrameStats poolStats = simulateFrames([&jobSystem](ChunkGenerator& generator, const std::vector<glm::vec3>& positions) {
+        std::vector<std::unique_ptr<ChunkPayload>> payloads(positions.size());
+        JobCounter jobs;
+        for (size_t i = 0; i < positions.size(); i++)
+            jobSystem.submit([&generator, &payloads, &positions, i]() {
+                payloads[i] = generator.generateChunkData(positions[i]);
+            }, &jobs);
+        jobSystem.wait(jobs);
+        return payloads;
+    });
+    std::cout << "(" << jobSystem.workerCount() << " workers + waiting thread)" << std::endl;
+    report("job system      ", poolStats);
+}
@@ -0,0 +1,100 @@
+#include <random>
+#include <vector>
+
+#include "Bench.h"
+#include "ChunkGenerator.h"
+#include "Components.h"
+#include "LightEngine.h"
+
+namespace {
+
+const int areaChunks = 5;
+
+// stitched areaChunks x areaChunks patch of world, each pass edits its own copy
+struct LitArea {
+    entt::registry registry;
+    ChunkMapComponent* chunkMap;
+    LightEngine lightEngine {registry};
+
+    explicit LitArea(ChunkGenerator& generator) {
+        entt::entity e_ChunkMap = registry.create();
+        chunkMap = &registry.emplace<ChunkMapComponent>(e_ChunkMap, registry);
+        for (int z = 0; z < areaChunks; z++)
+            for (int x = 0; x < areaChunks; x++)
+            {
+                std::unique_ptr<ChunkPayload> payload = generator.generateChunkData(
+                        glm::vec3(x * CHUNK_WIDTH, 0, z * CHUNK_WIDTH));
+                entt::entity e_Chunk = registry.create();
+                registry.emplace<ChunkComponent>(e_Chunk, std::move(payload->chunk));
+                chunkMap->insertChunk(e_Chunk, {x * CHUNK_WIDTH, z * CHUNK_WIDTH});
+                lightEngine.stitchChunk(e_Chunk);
+            }
+    }
+};
+
+}
+
+// breaks and places blocks around the surface of a 5x5 area and compares relighting the edited chunk
+// from scratch (the old edit path) against LightEngine's incremental removal/re-propagation
+// then times placing and breaking light sources
+void runLightEngineBench()
+{
+    benchHeader("LightEngine: full chunk relight vs incremental edit");
+
+    ChunkGenerator generator(5271998);
+    LitArea fullArea(generator);
+    LitArea incrementalArea(generator);
+
+    // edits alternate between digging into and building on top of the surface
+    const int edits = 2000;
+    std::mt19937 rng(1);
+    std::vector<std::pair<glm::ivec3, BlockType>> editList;
+    for (int i = 0; i < edits; i++)
+    {
+        glm::ivec3 pos(rng() % (areaChunks * CHUNK_WIDTH), CHUNK_HEIGHT - 1, rng() % (areaChunks * CHUNK_WIDTH));
+        while (pos.y > 0 && fullArea.chunkMap->blockAt(pos)->isTransparent())
+            pos.y--;
+        bool dig = i % 2 == 0;
+        editList.emplace_back(dig ? pos : pos + glm::ivec3(0, 1, 0), dig ? AIR : STONE);
+    }
+
+    auto runEdits = [&](LitArea& area, auto relight) {
+        BenchTimer timer;
+        for (auto& [pos, type] : editList)
+        {
+            area.chunkMap->setBlock(pos, type);
+            relight(area, pos);
+        }
+        return timer.elapsedMs() * 1000.0 / edits;
+    };
+
+    double fullUs = runEdits(fullArea, [](LitArea& area, const glm::ivec3& pos) {
+        entt::entity e_Chunk = (*area.chunkMap)[ChunkMapComponent::chunkOf(pos)];
+        ChunkGenerator::updateLightMap(area.registry.get<ChunkComponent>(e_Chunk));
+    });
+    size_t touchedChunks = 0;
+    double incrementalUs = runEdits(incrementalArea, [&touchedChunks](LitArea& area, const glm::ivec3& pos) {
+        touchedChunks += area.lightEngine.updateBlockLight(pos).size();
+    });
+
+    // light sources: placing/breaking glowstone just above the surface floods/clears its whole light radius
+    const int sources = 200;
+    BenchTimer sourceTimer;
+    for (int i = 0; i < sources; i++)
+    {
+        glm::ivec3 pos(rng() % (areaChunks * CHUNK_WIDTH), CHUNK_HEIGHT - 1, rng() % (areaChunks * CHUNK_WIDTH));
+        while (pos.y > 0 && incrementalArea.chunkMap->blockAt(pos)->isTransparent())
+            pos.y--;
+        pos.y++;
+        incrementalArea.chunkMap->setBlock(pos, GLOWSTONE);
+        incrementalArea.lightEngine.updateBlockLight(pos);
+        incrementalArea.chunkMap->setBlock(pos, AIR);
+        incrementalArea.lightEngine.updateBlockLight(pos);
+    }
+    double sourceUs = sourceTimer.elapsedMs() * 1000.0 / (2 * sources);
+
+    std::cout << "full relight: " << fullUs << " us/edit (" << CHUNK_VOLUME << " voxels each)" << std::endl;
+    std::cout << "incremental:  " << incrementalUs << " us/edit (" << static_cast<double>(touchedChunks) / edits
+              << " chunks remeshed per edit)" << std::endl;
+    std::cout << "light source: " << sourceUs << " us per glowstone placed or broken" << std::endl;
+}
@@ -0,0 +1,73 @@
+#include <random>
+#include <vector>
+
+#include "Bench.h"
+#include "ChunkGenerator.h"
+
+namespace {
+
+// relights every chunk with the given method, returns chunks lit per second
+double chunksPerSecond(std::vector<ChunkComponent>& chunks, LightPropagation method, int passes)
+{
+    BenchTimer timer;
+    for (int pass = 0; pass < passes; pass++)
+        for (ChunkComponent& chunkComp : chunks)
+        {
+            ChunkGenerator::updateLightMap(chunkComp, method);
+            doNotOptimize(chunkComp.lightMap.data());
+        }
+    return chunks.size() * passes / (timer.elapsedMs() / 1000.0);
+}
+
+void compare(const char* name, std::vector<ChunkComponent>& chunks)
+{
+    const int passes = 20;
+    double breadthFirst = chunksPerSecond(chunks, LightPropagation::BREADTH_FIRST, passes);
+    std::vector<std::vector<uint8_t>> expected;
+    for (ChunkComponent& chunkComp : chunks)
+        expected.push_back(chunkComp.lightMap);
+
+    double bitPlanes = chunksPerSecond(chunks, LightPropagation::BIT_PLANES, passes);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < chunks.size(); i++)
+        mismatches += chunks[i].lightMap != expected[i];
+
+    std::cout << name << ": BFS " << breadthFirst << " chunks/s, bit planes " << bitPlanes << " chunks/s ("
+              << bitPlanes / breadthFirst << "x), " << mismatches << " light maps differ" << std::endl;
+}
+
+}
+
+// lights generated chunks with the queue BFS and with BitLightPropagator, on plain terrain and on terrain
+// dug through with tunnels and scattered glowstone (light has to bend around corners, torchlight is used)
+void runLightPropagationBench()
+{
+    benchHeader("Light propagation: BFS vs bit planes");
+
+    ChunkGenerator generator(5271998);
+    std::vector<ChunkComponent> plain, dug;
+    std::mt19937 rng(1);
+    for (int z = 0; z < 8; z++)
+        for (int x = 0; x < 8; x++)
+        {
+            glm::vec3 chunkPos(x * CHUNK_WIDTH, 0, z * CHUNK_WIDTH);
+            plain.push_back(std::move(generator.generateChunkData(chunkPos)->chunk));
+
+            ChunkComponent chunkComp = std::move(generator.generateChunkData(chunkPos)->chunk);
+            for (int y = 40; y < 44; y++) // tunnels along both axes, open to the sky at the chunk's surface
+                for (int i = 0; i < CHUNK_WIDTH; i++)
+                {
+                    chunkComp.setBlock(glm::ivec3(i, y, 7), AIR);
+                    chunkComp.setBlock(glm::ivec3(7, y, i), AIR);
+                }
+            for (int y = 44; y < CHUNK_HEIGHT; y++)
+                chunkComp.setBlock(glm::ivec3(0, y, 7), AIR);
+            for (int i = 0; i < 200; i++)
+                chunkComp.setBlock(glm::ivec3(rng() % CHUNK_WIDTH, 40 + rng() % 80, rng() % CHUNK_WIDTH),
+                                   (i % 10 == 0) ? GLOWSTONE : AIR);
+            dug.push_back(std::move(chunkComp));
+        }
+
+    compare("plain terrain", plain);
+    compare("dug + glowstone", dug);
+}
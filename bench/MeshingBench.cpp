@@ -0,0 +1,135 @@
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "Bench.h"
+#include "ChunkGenerator.h"
+#include "ChunkMeshingSystem.h"
+#include "ChunkSnapshot.h"
+#include "Components.h"
+
+namespace {
+
+const int areaChunks = 6;
+
+// chunk vertex layout before texArrayVertex was packed: world position, uv + layer as floats, light byte,
+// 6 per quad drawn without indices
+struct FloatVertex {
+    float xWorldPos, yWorldPos, zWorldPos;
+    float uTexCoord, vTexCoord, pictureNum;
+    uint8_t lightLevel;
+};
+
+// a chunk's sections back to back, for comparing whole meshes
+std::vector<texArrayVertex> chunkVertices(const MeshComponent& meshComp)
+{
+    std::vector<texArrayVertex> vertices;
+    for (const std::vector<texArrayVertex>& sectionVertices : meshComp.sectionVertices)
+        vertices.insert(vertices.end(), sectionVertices.begin(), sectionVertices.end());
+    return vertices;
+}
+
+// areaChunks x areaChunks patch of world, the inner chunks have all four neighbours and are meshed
+struct MeshArea {
+    entt::registry registry;
+    std::vector<entt::entity> inner;
+
+    MeshArea(ChunkGenerator& generator, bool dig) {
+        entt::entity e_ChunkMap = registry.create();
+        ChunkMapComponent& chunkMap = registry.emplace<ChunkMapComponent>(e_ChunkMap, registry);
+        std::mt19937 rng(1);
+        for (int z = 0; z < areaChunks; z++)
+            for (int x = 0; x < areaChunks; x++)
+            {
+                glm::vec3 chunkPos(x * CHUNK_WIDTH, 0, z * CHUNK_WIDTH);
+                entt::entity e_Chunk = registry.create();
+                registry.emplace<PositionComponent>(e_Chunk, chunkPos);
+                registry.emplace<MeshComponent>(e_Chunk);
+                ChunkComponent& chunkComp = registry.emplace<ChunkComponent>(
+                        e_Chunk, std::move(generator.generateChunkData(chunkPos)->chunk));
+                // scattered holes and glowstone break up the merged quads, closer to a mined-out area
+                for (int i = 0; dig && i < 400; i++)
+                    chunkComp.setBlock(glm::ivec3(rng() % CHUNK_WIDTH, 30 + rng() % 60, rng() % CHUNK_WIDTH),
+                                       (i % 10 == 0) ? GLOWSTONE : AIR);
+                ChunkGenerator::updateLightMap(chunkComp);
+                chunkMap.insertChunk(e_Chunk, {x * CHUNK_WIDTH, z * CHUNK_WIDTH});
+                if (x > 0 && z > 0 && x < areaChunks - 1 && z < areaChunks - 1)
+                    inner.push_back(e_Chunk);
+            }
+    }
+
+    // meshes every inner chunk passes times, returns microseconds per chunk
+    double meshUs(ChunkMeshingSystem& meshingSystem, MeshingMethod method, int passes,
+                  uint64_t parts = ALL_MESH_PARTS) {
+        BenchTimer timer;
+        for (int pass = 0; pass < passes; pass++)
+            for (entt::entity e_Chunk : inner)
+            {
+                meshingSystem.meshChunk(e_Chunk, registry, method, parts);
+                doNotOptimize(registry.get<MeshComponent>(e_Chunk).sectionVertices.data());
+            }
+        return timer.elapsedMs() * 1000.0 / (inner.size() * passes);
+    }
+};
+
+void compare(const char* name, ChunkGenerator& generator, bool dig)
+{
+    MeshArea area(generator, dig);
+    JobSystem jobSystem(1);
+    ChunkMeshingSystem meshingSystem(jobSystem);
+    const int passes = 20;
+
+    double greedyUs = area.meshUs(meshingSystem, MeshingMethod::GREEDY, passes);
+    std::vector<std::vector<texArrayVertex>> expected;
+    for (entt::entity e_Chunk : area.inner)
+        expected.push_back(chunkVertices(area.registry.get<MeshComponent>(e_Chunk)));
+
+    double binaryUs = area.meshUs(meshingSystem, MeshingMethod::BINARY_GREEDY, passes);
+    size_t mismatches = 0, vertexCount = 0;
+    for (size_t i = 0; i < area.inner.size(); i++)
+    {
+        std::vector<texArrayVertex> vertices = chunkVertices(area.registry.get<MeshComponent>(area.inner[i]));
+        vertexCount += vertices.size();
+        mismatches += vertices.size() != expected[i].size()
+                      || std::memcmp(vertices.data(), expected[i].data(), vertices.size() * sizeof(texArrayVertex)) != 0;
+    }
+
+    std::cout << name << ": greedy " << greedyUs << " us/chunk, binary greedy " << binaryUs << " us/chunk ("
+              << greedyUs / binaryUs << "x), "
+              << mismatches << " meshes differ" << std::endl;
+    // what a neighbour loading or unloading costs: one border part instead of the whole chunk
+    double borderUs = area.meshUs(meshingSystem, MeshingMethod::BINARY_GREEDY, passes, borderMeshParts(WEST));
+    std::cout << name << ": binary greedy west border only " << borderUs << " us/chunk" << std::endl;
+    // what a block edit costs: the section holding it (y 48 to 63, around the surface) instead of the whole chunk
+    double sectionUs = area.meshUs(meshingSystem, MeshingMethod::BINARY_GREEDY, passes, sectionMeshParts(1 << 3));
+    std::cout << name << ": binary greedy one section " << sectionUs << " us/chunk" << std::endl;
+    // the main thread's share of every meshing job, included in the timings above
+    BenchTimer snapshotTimer;
+    for (int pass = 0; pass < passes; pass++)
+        for (entt::entity e_Chunk : area.inner)
+        {
+            ChunkSnapshot snapshot(area.registry, e_Chunk);
+            doNotOptimize(&snapshot);
+        }
+    std::cout << name << ": padded snapshot " << snapshotTimer.elapsedMs() * 1000.0 / (area.inner.size() * passes)
+              << " us/chunk" << std::endl;
+    size_t quadsPerChunk = vertexCount / area.inner.size() / VERTICES_PER_QUAD;
+    std::cout << name << ": " << quadsPerChunk << " quads/chunk, vertex buffer "
+              << quadsPerChunk * VERTICES_PER_QUAD * sizeof(texArrayVertex) << " bytes/chunk packed + indexed ("
+              << VERTICES_PER_QUAD * sizeof(texArrayVertex) << " B/quad), "
+              << quadsPerChunk * 6 * sizeof(FloatVertex) << " bytes/chunk as float triangles ("
+              << 6 * sizeof(FloatVertex) << " B/quad)" << std::endl;
+}
+
+}
+
+// meshes the inner chunks of a generated area with the cell by cell greedy mesher and the bit mask one,
+// on plain terrain and on terrain riddled with holes (many small quads)
+void runMeshingBench()
+{
+    benchHeader("Chunk meshing: greedy vs binary greedy");
+
+    ChunkGenerator generator(5271998);
+    compare("plain terrain", generator, false);
+    compare("dug + glowstone", generator, true);
+}
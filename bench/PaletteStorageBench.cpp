@@ -0,0 +1,101 @@
+#include <vector>
+#include <entt/entt.hpp>
+
+#include "Bench.h"
+#include "ChunkGenerator.h"
+
+// compares palette-compressed chunk storage against the previous one-pointer-per-voxel layout
+void runPaletteStorageBench()
+{
+    benchHeader("palette storage vs std::vector<const Block*>");
+
+    entt::registry registry;
+    ChunkGenerator generator(5271998);
+
+    // same 21x21 square ChunkLoaderSystem keeps loaded around the player
+    const int loadDistance = 10;
+    std::vector<entt::entity> chunks;
+    for (int zOff = -loadDistance; zOff <= loadDistance; zOff++)
+        for (int xOff = -loadDistance; xOff <= loadDistance; xOff++)
+        {
+            std::unique_ptr<ChunkPayload> payload =
+                    generator.generateChunkData(glm::vec3(xOff * CHUNK_WIDTH, 0, zOff * CHUNK_WIDTH));
+            entt::entity e_Chunk = registry.create();
+            registry.emplace<ChunkComponent>(e_Chunk, std::move(payload->chunk));
+            chunks.push_back(e_Chunk);
+        }
+
+    // rebuild the old layout from the generated chunks
+    std::vector<std::vector<const Block*>> pointerChunks;
+    size_t paletteBytes = 0;
+    int maxPalette = 0;
+    for (entt::entity e_Chunk : chunks)
+    {
+        const ChunkComponent& chunkComp = registry.get<ChunkComponent>(e_Chunk);
+        for (int i = 0; i < CHUNK_SECTIONS; i++)
+        {
+            const PaletteStorage& storage = chunkComp.sectionAt(i).storage();
+            paletteBytes += storage.memoryUsage();
+            maxPalette = std::max(maxPalette, storage.paletteSize());
+        }
+
+        std::vector<const Block*> blocks(CHUNK_VOLUME);
+        for (int y = 0; y < CHUNK_HEIGHT; y++)
+            for (int z = 0; z < CHUNK_WIDTH; z++)
+                for (int x = 0; x < CHUNK_WIDTH; x++)
+                    blocks[x + z * CHUNK_WIDTH + y * CHUNK_WIDTH * CHUNK_WIDTH] = chunkComp.blockAt(x, y, z);
+        pointerChunks.push_back(std::move(blocks));
+    }
+    size_t pointerBytes = chunks.size() * (sizeof(std::vector<const Block*>) + CHUNK_VOLUME * sizeof(const Block*));
+
+    std::cout << "chunks: " << chunks.size() << ", largest section palette: " << maxPalette << "\n";
+    std::cout << "pointer layout: " << pointerBytes / chunks.size() << " B/chunk, "
+              << pointerBytes / (1024.0 * 1024.0) << " MiB total\n";
+    std::cout << "palette layout: " << paletteBytes / chunks.size() << " B/chunk, "
+              << paletteBytes / (1024.0 * 1024.0) << " MiB total\n";
+
+    // read throughput: walk every voxel the way lighting/meshing does and count opaque blocks
+    const int passes = 5;
+    BenchTimer timer;
+    size_t opaque = 0;
+    for (int p = 0; p < passes; p++)
+        for (auto& blocks : pointerChunks)
+            for (int i = 0; i < CHUNK_VOLUME; i++)
+                opaque += not blocks[i]->isTransparent();
+    double pointerMs = timer.elapsedMs();
+    doNotOptimize(opaque);
+
+    timer.reset();
+    opaque = 0;
+    for (int p = 0; p < passes; p++)
+        for (entt::entity e_Chunk : chunks)
+        {
+            const ChunkComponent& chunkComp = registry.get<ChunkComponent>(e_Chunk);
+            for (int y = 0; y < CHUNK_HEIGHT; y++)
+                for (int z = 0; z < CHUNK_WIDTH; z++)
+                    for (int x = 0; x < CHUNK_WIDTH; x++)
+                        opaque += not chunkComp.blockAt(x, y, z)->isTransparent();
+        }
+    double paletteMs = timer.elapsedMs();
+    doNotOptimize(opaque);
+
+    // hot loops that only need the type can skip the Block pointer lookup entirely
+    timer.reset();
+    opaque = 0;
+    for (int p = 0; p < passes; p++)
+        for (entt::entity e_Chunk : chunks)
+        {
+            const ChunkComponent& chunkComp = registry.get<ChunkComponent>(e_Chunk);
+            for (int y = 0; y < CHUNK_HEIGHT; y++)
+                for (int z = 0; z < CHUNK_WIDTH; z++)
+                    for (int x = 0; x < CHUNK_WIDTH; x++)
+                        opaque += chunkComp.typeAt(x, y, z) != AIR;
+        }
+    double paletteTypeMs = timer.elapsedMs();
+    doNotOptimize(opaque);
+
+    double voxels = static_cast<double>(passes) * chunks.size() * CHUNK_VOLUME;
+    std::cout << "pointer reads: " << voxels / pointerMs / 1000.0 << " Mvoxel/s\n";
+    std::cout << "palette reads (blockAt): " << voxels / paletteMs / 1000.0 << " Mvoxel/s\n";
+    std::cout << "palette reads (typeAt): " << voxels / paletteTypeMs / 1000.0 << " Mvoxel/s" << std::endl;
+}
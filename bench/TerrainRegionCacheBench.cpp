@@ -0,0 +1,40 @@
+#include <vector>
+
+#include "Bench.h"
+#include "ChunkGenerator.h"
+#include "JobSystem.h"
+
+// looks up the terrain columns of the 21x21 load window, walks away far enough to leave it, then walks back in
+// the first visit samples noise for every chunk, the second finds all of them in the region cache
+void runTerrainRegionCacheBench()
+{
+    benchHeader("TerrainRegionCache: first visit vs revisit");
+
+    ChunkGenerator generator(5271998);
+    JobSystem jobSystem;
+
+    const int loadDistance = 10;
+    auto lookUpWindow = [&](int centerX) {
+        BenchTimer timer; // includes submitting, a cache hit takes about as long as handing out its job
+        JobCounter jobs;
+        for (int zOff = -loadDistance; zOff <= loadDistance; zOff++)
+            for (int xOff = -loadDistance; xOff <= loadDistance; xOff++)
+                jobSystem.submit([&generator, xOff, zOff, centerX]() {
+                    glm::vec3 pos((centerX + xOff) * CHUNK_WIDTH, 0, zOff * CHUNK_WIDTH);
+                    doNotOptimize(generator.terrainColumnsOf(pos));
+                }, &jobs);
+        jobSystem.wait(jobs);
+        return timer.elapsedMs();
+    };
+
+    double firstMs = lookUpWindow(0);
+    lookUpWindow(2 * loadDistance + 1); // next window over, still within the cached regions
+    double revisitMs = lookUpWindow(0);
+
+    int chunks = (2 * loadDistance + 1) * (2 * loadDistance + 1);
+    const TerrainRegionCache& cache = generator.regionCache();
+    std::cout << "first visit: " << firstMs << " ms (" << chunks / (firstMs / 1000.0) << " chunks/s)" << std::endl;
+    std::cout << "revisit:     " << revisitMs << " ms (" << chunks / (revisitMs / 1000.0) << " chunks/s)" << std::endl;
+    std::cout << cache.hitCount() << " hits, " << cache.missCount() << " misses in " << cache.regionCount()
+              << " regions" << std::endl;
+}
@@ -3,11 +3,14 @@
 out vec4 FragColor;
 
 in float sunlightLevel;
+in float torchlightLevel;
 in vec3 texArrayCoords;
 
 uniform sampler2DArray arrayTexture;
 
 void main()
 {
-    FragColor = vec4(texture(arrayTexture, texArrayCoords).xyz * sunlightLevel, 1.0f);
+    // brighter of the two channels wins, torchlight slightly warm
+    vec3 light = max(vec3(sunlightLevel), torchlightLevel * vec3(1.0, 0.9, 0.75));
+    FragColor = vec4(texture(arrayTexture, texArrayCoords).xyz * light, 1.0f);
 }
\ No newline at end of file
@@ -1,18 +1,25 @@
 #version 330 core
 
-layout (location = 0) in vec3 aWorldPos;
-layout (location = 1) in vec3 aTexArrayCoords;
-layout (location = 2) in int alightLevel;
+// packed texArrayVertex, see Texture.h
+layout (location = 0) in uint aPositionU; // x | y << 5 | z << 13 | u << 18 | face << 26
+layout (location = 1) in uint aVLayerLight; // v | layer << 8 | light << 16
 
 out vec3 texArrayCoords;
 out float sunlightLevel;
+out float torchlightLevel;
 
 uniform mat4 view;
 uniform mat4 projection;
+uniform vec3 chunkOrigin; // world position of the chunk's (0, 0, 0) corner
+uniform float skyBrightness; // time of day factor, sunlight levels in the mesh stay absolute
 
 void main()
 {
-    gl_Position = projection * view * vec4(aWorldPos, 1.0);
-    texArrayCoords = aTexArrayCoords;
-    sunlightLevel = float(alightLevel & 0xF)/15.0;
+    vec3 localPos = vec3(aPositionU & 0x1Fu, (aPositionU >> 5) & 0xFFu, (aPositionU >> 13) & 0x1Fu);
+    gl_Position = projection * view * vec4(chunkOrigin + localPos, 1.0);
+    texArrayCoords = vec3((aPositionU >> 18) & 0xFFu, aVLayerLight & 0xFFu, (aVLayerLight >> 8) & 0xFFu);
+    // low nibble sunlight, high nibble torchlight
+    uint lightLevel = (aVLayerLight >> 16) & 0xFFu;
+    sunlightLevel = float(lightLevel & 0xFu)/15.0 * skyBrightness;
+    torchlightLevel = float((lightLevel >> 4) & 0xFu)/15.0;
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "BiomeSampler.h"
+
+static_assert(CHUNK_WIDTH % BiomeSampler::LATTICE_SPACING == 0);
+
+namespace {
+    // noise [-1, 1] -> [0, 1]
+    float scale(float val) { return (val + 1.0f)/2.0f; }
+}
+
+BiomeSampler::BiomeSampler(int temperatureSeed, int precipitationSeed)
+{
+    temperatureNoise.setSeed(temperatureSeed);
+    temperatureNoise.setFrequency(0.0008);
+    precipitationNoise.setSeed(precipitationSeed);
+    precipitationNoise.setFrequency(0.0008);
+}
+
+void BiomeSampler::sampleExact(const glm::vec3& chunkPos, BiomeMap& biomes) const
+{
+    float temperature[CHUNK_WIDTH * CHUNK_WIDTH];
+    float precipitation[CHUNK_WIDTH * CHUNK_WIDTH];
+    temperatureNoise.getNoiseTile(chunkPos.x, chunkPos.z, CHUNK_WIDTH, CHUNK_WIDTH, temperature);
+    precipitationNoise.getNoiseTile(chunkPos.x, chunkPos.z, CHUNK_WIDTH, CHUNK_WIDTH, precipitation);
+    for (int i = 0; i < CHUNK_WIDTH * CHUNK_WIDTH; i++)
+        // also include elevation? idts it changes too fast
+        biomes[i] = biomeLookup(scale(temperature[i]), scale(precipitation[i]));
+}
+
+void BiomeSampler::sampleCoarse(const glm::vec3& chunkPos, BiomeMap& biomes) const
+{
+    float temperature[LATTICE_POINTS * LATTICE_POINTS];
+    float precipitation[LATTICE_POINTS * LATTICE_POINTS];
+    temperatureNoise.getNoiseTile(chunkPos.x, chunkPos.z, LATTICE_POINTS, LATTICE_POINTS, temperature, LATTICE_SPACING);
+    precipitationNoise.getNoiseTile(chunkPos.x, chunkPos.z, LATTICE_POINTS, LATTICE_POINTS, precipitation,
+                                    LATTICE_SPACING);
+
+    // bilinear interpolation within each lattice cell
+    auto interpolate = [](const float* lattice, int cellX, int cellZ, float tx, float tz) {
+        const float* corner = lattice + cellX + cellZ * LATTICE_POINTS;
+        float low = corner[0] + (corner[1] - corner[0]) * tx;
+        float high = corner[LATTICE_POINTS] + (corner[LATTICE_POINTS + 1] - corner[LATTICE_POINTS]) * tx;
+        return low + (high - low) * tz;
+    };
+
+    for (int z = 0; z < CHUNK_WIDTH; z++)
+        for (int x = 0; x < CHUNK_WIDTH; x++)
+        {
+            int cellX = x / LATTICE_SPACING, cellZ = z / LATTICE_SPACING;
+            float tx = static_cast<float>(x % LATTICE_SPACING) / LATTICE_SPACING;
+            float tz = static_cast<float>(z % LATTICE_SPACING) / LATTICE_SPACING;
+            biomes[x + z * CHUNK_WIDTH] = biomeLookup(scale(interpolate(temperature, cellX, cellZ, tx, tz)),
+                                                      scale(interpolate(precipitation, cellX, cellZ, tx, tz)));
+        }
+}
+
+BiomeType BiomeSampler::biomeLookup(float temperature, float precipitation) {
+    if (temperature > 0.8f && precipitation < 0.2f)
+        return SandBiome;
+
+    return GrassBiome;
+}
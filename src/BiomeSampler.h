@@ -0,0 +1,31 @@
+#pragma once
+
+#include <array>
+#include <glm/vec3.hpp>
+
+#include "Chunk.h"
+#include "Biome.h"
+#include "GridNoise.h"
+
+// classifies each column of a chunk into a biome from low-frequency temperature and precipitation noise
+class BiomeSampler {
+public:
+    using BiomeMap = std::array<BiomeType, CHUNK_WIDTH * CHUNK_WIDTH>;
+
+    // blocks between lattice points, must divide CHUNK_WIDTH so chunks share their border lattice points
+    static const int LATTICE_SPACING = 4;
+    static const int LATTICE_POINTS = CHUNK_WIDTH / LATTICE_SPACING + 1; // per axis, both chunk edges included
+
+    BiomeSampler(int temperatureSeed, int precipitationSeed);
+
+    // two noise samples per column
+    void sampleExact(const glm::vec3& chunkPos, BiomeMap& biomes) const;
+    // noise sampled on the coarse lattice only, bilinearly interpolated for each column before classification
+    void sampleCoarse(const glm::vec3& chunkPos, BiomeMap& biomes) const;
+
+    static BiomeType biomeLookup(float temperature, float precipitation);
+
+private:
+    GridNoise temperatureNoise;
+    GridNoise precipitationNoise;
+};
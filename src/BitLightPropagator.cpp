@@ -0,0 +1,250 @@
+#include "BitLightPropagator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+    const int SUNLIGHT_SHIFT = 0;
+    const int TORCHLIGHT_SHIFT = 4;
+    const int LAYER_AREA = CHUNK_WIDTH * CHUNK_WIDTH;
+}
+
+void BitLightPropagator::updateLightMap(ChunkComponent& chunkComp)
+{
+    BitLightPropagator propagator;
+    chunkComp.clearLightMap();
+    propagator.buildMasks(chunkComp);
+
+    propagator.seedSunlight(chunkComp);
+    propagator.propagate(chunkComp, 15, SUNLIGHT_SHIFT);
+
+    // torchlight starts dark and is seeded at each emitter's own level as the steps get there
+    if (propagator.m_Emitters.empty())
+        return;
+    std::memset(propagator.m_Lit.data(), 0, sizeof(Plane));
+    propagator.m_Changed.fill(false);
+    propagator.propagate(chunkComp, propagator.m_Emitters.front().level, TORCHLIGHT_SHIFT);
+}
+
+void BitLightPropagator::buildMasks(const ChunkComponent& chunkComp)
+{
+    const BlockPool& blockPool = BlockPool::getPoolInstance();
+    m_Emitters.clear();
+    m_NextEmitter = 0;
+    for (int sectionIdx = 0; sectionIdx < CHUNK_SECTIONS; sectionIdx++)
+    {
+        const ChunkSection& section = chunkComp.sectionAt(sectionIdx);
+        Layer* layers = &m_Transparent[sectionIdx * SECTION_HEIGHT];
+        if (section.isUniform() && blockPool.getBlockPtr(section.uniformType())->lightEmission() == 0)
+        {
+            uint16_t row = blockPool.getBlockPtr(section.uniformType())->isTransparent() ? 0xFFFF : 0;
+            for (int y = 0; y < SECTION_HEIGHT; y++)
+                std::fill(std::begin(layers[y].rows), std::end(layers[y].rows), row);
+            continue;
+        }
+
+        // look blocks up once per palette entry instead of once per voxel
+        const PaletteStorage& storage = section.storage();
+        std::vector<bool> transparentEntries, emitterEntries;
+        for (BlockType type : storage.palette())
+        {
+            const Block* block = blockPool.getBlockPtr(type);
+            transparentEntries.push_back(block->isTransparent());
+            emitterEntries.push_back(block->lightEmission() > 0);
+        }
+
+        uint16_t rows[SECTION_VOLUME / CHUNK_WIDTH];
+        storage.matchMask(transparentEntries, rows);
+        for (int y = 0; y < SECTION_HEIGHT; y++)
+            std::copy_n(rows + y * CHUNK_WIDTH, CHUNK_WIDTH, layers[y].rows);
+
+        storage.matchMask(emitterEntries, rows);
+        for (int row = 0; row < SECTION_VOLUME / CHUNK_WIDTH; row++)
+            for (uint16_t emitters = rows[row]; emitters != 0; emitters &= emitters - 1)
+            {
+                int voxel = row * CHUNK_WIDTH + std::countr_zero(emitters);
+                m_Emitters.push_back({sectionIdx * SECTION_VOLUME + voxel,
+                                      blockPool.getBlockPtr(storage.get(voxel))->lightEmission()});
+            }
+    }
+    // brightest first, propagate() seeds them as it counts down
+    std::stable_sort(m_Emitters.begin(), m_Emitters.end(), [](const Emitter& a, const Emitter& b) {
+        return a.level > b.level;
+    });
+}
+
+void BitLightPropagator::seedSunlight(ChunkComponent& chunkComp)
+{
+    // sky voxels (at or above their column's heightmap entry) are the level 15 sources, as in the BFS
+    int minHeight = CHUNK_HEIGHT, maxHeight = 0;
+    for (int z = 0; z < CHUNK_WIDTH; z++)
+        for (int x = 0; x < CHUNK_WIDTH; x++)
+        {
+            minHeight = std::min(minHeight, chunkComp.skyHeight(x, z));
+            maxHeight = std::max(maxHeight, chunkComp.skyHeight(x, z));
+        }
+    // the light map was just cleared: sky layers are a plain memset and torchlight needs no masking
+    std::memset(&chunkComp.lightMap[maxHeight * LAYER_AREA], 15, (CHUNK_HEIGHT - maxHeight) * LAYER_AREA);
+    std::memset(m_Lit.data(), 0, sizeof(Layer) * minHeight);
+    std::memset(m_Lit.data() + maxHeight, 0xFF, sizeof(Layer) * (CHUNK_HEIGHT - maxHeight));
+    m_Changed.fill(false);
+
+    // in between, a layer's sky voxels are the layer below's plus the columns whose heightmap entry it is
+    std::array<Layer, CHUNK_HEIGHT + 1> skyFrom {};
+    for (int z = 0; z < CHUNK_WIDTH; z++)
+        for (int x = 0; x < CHUNK_WIDTH; x++)
+            skyFrom[chunkComp.skyHeight(x, z)].rows[z] |= 1 << x;
+    // light map bytes for the 16 ways sky voxels can fill 4 neighbouring x
+    static const std::array<std::array<uint8_t, 4>, 16> nibbleLight = [] {
+        std::array<std::array<uint8_t, 4>, 16> table {};
+        for (int nibble = 0; nibble < 16; nibble++)
+            for (int bit = 0; bit < 4; bit++)
+                table[nibble][bit] = (nibble & (1 << bit)) ? 15 : 0;
+        return table;
+    }();
+    Layer sky {};
+    for (int y = minHeight; y < maxHeight; y++)
+    {
+        uint8_t* layerLight = &chunkComp.lightMap[y * LAYER_AREA];
+        for (int z = 0; z < CHUNK_WIDTH; z++)
+        {
+            sky.rows[z] |= skyFrom[y].rows[z];
+            for (int nibbleIdx = 0; nibbleIdx < 4; nibbleIdx++)
+            {
+                std::memcpy(layerLight + z * CHUNK_WIDTH + nibbleIdx * 4,
+                            nibbleLight[(sky.rows[z] >> (nibbleIdx * 4)) & 0xF].data(), 4);
+            }
+        }
+        m_Lit[y] = sky;
+        m_Changed[y] = true;
+    }
+}
+
+void BitLightPropagator::seedEmitters(ChunkComponent& chunkComp, int level)
+{
+    for (; m_NextEmitter < m_Emitters.size() && m_Emitters[m_NextEmitter].level == level; m_NextEmitter++)
+    {
+        int index = m_Emitters[m_NextEmitter].index;
+        int y = index / LAYER_AREA;
+        int z = (index / CHUNK_WIDTH) % CHUNK_WIDTH;
+        uint16_t bit = 1 << (index % CHUNK_WIDTH);
+        if (m_Lit[y].rows[z] & bit)
+            continue; // already as bright from a stronger emitter
+        m_Lit[y].rows[z] |= bit;
+        m_Changed[y] = true;
+        chunkComp.lightMap[index] = (chunkComp.lightMap[index] & 0x0F) | (level << TORCHLIGHT_SHIFT);
+    }
+}
+
+void BitLightPropagator::propagate(ChunkComponent& chunkComp, int fromLevel, int channelShift)
+{
+    for (int level = fromLevel; level >= 1; level--)
+    {
+        if (level < fromLevel)
+        {
+            // only layers next to one that changed can grow; all of them read m_Lit before any is updated
+            std::array<bool, CHUNK_HEIGHT> grown {};
+            bool anyGrown = false;
+            for (int y = 0; y < CHUNK_HEIGHT; y++)
+            {
+                bool nearChange = m_Changed[y] || (y > 0 && m_Changed[y - 1]) || (y + 1 < CHUNK_HEIGHT && m_Changed[y + 1]);
+                grown[y] = nearChange && growLayer(y);
+                anyGrown |= grown[y];
+            }
+            for (int y = 0; y < CHUNK_HEIGHT; y++)
+            {
+                if (not grown[y])
+                    continue;
+                for (int z = 0; z < CHUNK_WIDTH; z++)
+                    m_Lit[y].rows[z] |= m_Added[y].rows[z];
+                writeLevel(chunkComp, m_Added[y], y, level, channelShift);
+            }
+            m_Changed = grown;
+            if (not anyGrown && m_NextEmitter == m_Emitters.size())
+                return; // light stopped spreading and nothing is left to seed
+        }
+        if (channelShift == TORCHLIGHT_SHIFT)
+            seedEmitters(chunkComp, level);
+    }
+}
+
+bool BitLightPropagator::growLayer(int y)
+{
+    static const Layer emptyLayer {};
+    const Layer& below = (y > 0) ? m_Lit[y - 1] : emptyLayer;
+    const Layer& above = (y + 1 < CHUNK_HEIGHT) ? m_Lit[y + 1] : emptyLayer;
+    const Layer& cur = m_Lit[y];
+
+#if defined(__SSE2__)
+    // rows 0-7 in lo, 8-15 in hi; a row (z) is one 16-bit lane, so lane shifts move along z and bit shifts along x
+    __m128i curLo = _mm_load_si128(reinterpret_cast<const __m128i*>(cur.rows));
+    __m128i curHi = _mm_load_si128(reinterpret_cast<const __m128i*>(cur.rows + 8));
+    __m128i grownLo = _mm_or_si128(_mm_slli_epi16(curLo, 1), _mm_srli_epi16(curLo, 1));
+    __m128i grownHi = _mm_or_si128(_mm_slli_epi16(curHi, 1), _mm_srli_epi16(curHi, 1));
+    // row z takes row z - 1 and row z + 1
+    grownLo = _mm_or_si128(grownLo, _mm_or_si128(_mm_slli_si128(curLo, 2),
+                                                 _mm_or_si128(_mm_srli_si128(curLo, 2), _mm_slli_si128(curHi, 14))));
+    grownHi = _mm_or_si128(grownHi, _mm_or_si128(_mm_or_si128(_mm_slli_si128(curHi, 2), _mm_srli_si128(curLo, 14)),
+                                                 _mm_srli_si128(curHi, 2)));
+    grownLo = _mm_or_si128(grownLo, _mm_or_si128(_mm_load_si128(reinterpret_cast<const __m128i*>(below.rows)),
+                                                 _mm_load_si128(reinterpret_cast<const __m128i*>(above.rows))));
+    grownHi = _mm_or_si128(grownHi, _mm_or_si128(_mm_load_si128(reinterpret_cast<const __m128i*>(below.rows + 8)),
+                                                 _mm_load_si128(reinterpret_cast<const __m128i*>(above.rows + 8))));
+    // new voxels: grown, transparent and not lit yet
+    __m128i addedLo = _mm_andnot_si128(curLo, _mm_and_si128(grownLo,
+            _mm_load_si128(reinterpret_cast<const __m128i*>(m_Transparent[y].rows))));
+    __m128i addedHi = _mm_andnot_si128(curHi, _mm_and_si128(grownHi,
+            _mm_load_si128(reinterpret_cast<const __m128i*>(m_Transparent[y].rows + 8))));
+    _mm_store_si128(reinterpret_cast<__m128i*>(m_Added[y].rows), addedLo);
+    _mm_store_si128(reinterpret_cast<__m128i*>(m_Added[y].rows + 8), addedHi);
+    __m128i any = _mm_or_si128(addedLo, addedHi);
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(any, _mm_setzero_si128())) != 0xFFFF;
+#else
+    // four rows per 64-bit word, masks keep x shifts from crossing into the neighbouring row
+    const uint64_t notLowestX = 0xFFFEFFFEFFFEFFFEull;
+    const uint64_t notHighestX = 0x7FFF7FFF7FFF7FFFull;
+    uint64_t words[4], belowWords[4], aboveWords[4], transparentWords[4];
+    std::memcpy(words, cur.rows, sizeof(words));
+    std::memcpy(belowWords, below.rows, sizeof(words));
+    std::memcpy(aboveWords, above.rows, sizeof(words));
+    std::memcpy(transparentWords, m_Transparent[y].rows, sizeof(words));
+
+    uint64_t added[4];
+    uint64_t any = 0;
+    for (int i = 0; i < 4; i++)
+    {
+        uint64_t prevWord = (i > 0) ? words[i - 1] : 0;
+        uint64_t nextWord = (i < 3) ? words[i + 1] : 0;
+        uint64_t grown = ((words[i] << 1) & notLowestX) | ((words[i] >> 1) & notHighestX)
+                | (words[i] << 16) | (prevWord >> 48) | (words[i] >> 16) | (nextWord << 48)
+                | belowWords[i] | aboveWords[i];
+        added[i] = grown & transparentWords[i] & ~words[i];
+        any |= added[i];
+    }
+    std::memcpy(m_Added[y].rows, added, sizeof(added));
+    return any != 0;
+#endif
+}
+
+void BitLightPropagator::writeLevel(ChunkComponent& chunkComp, const Layer& voxels, int y, int level, int channelShift)
+{
+    uint8_t keepMask = static_cast<uint8_t>(~(0xF << channelShift));
+    uint8_t levelBits = static_cast<uint8_t>(level << channelShift);
+    uint8_t* layerLight = &chunkComp.lightMap[y * LAYER_AREA];
+    for (int z = 0; z < CHUNK_WIDTH; z++)
+    {
+        unsigned int row = voxels.rows[z];
+        while (row != 0)
+        {
+            int x = std::countr_zero(row);
+            row &= row - 1;
+            uint8_t& entry = layerLight[x + z * CHUNK_WIDTH];
+            entry = (entry & keepMask) | levelBits;
+        }
+    }
+}
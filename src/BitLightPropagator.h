@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "Chunk.h"
+#include "ChunkComponent.h"
+
+// lights one chunk like ChunkGenerator's BFS, but a whole 16x16 layer at a time as bit masks (one row of x per uint16)
+// light falls off by one per step, so the voxels lit >= level-1 are the voxels lit >= level, grown by one voxel
+// in all six directions and masked by transparency; each step writes its level to the voxels it newly reached
+// results are identical to the BFS; layers are processed 128 bits at a time with SSE2, 64 bits at a time otherwise
+class BitLightPropagator {
+public:
+    // recomputes sunlight and torchlight of chunkComp from its blocks and heightmap
+    static void updateLightMap(ChunkComponent& chunkComp);
+
+private:
+    struct alignas(16) Layer {
+        uint16_t rows[CHUNK_WIDTH]; // bit x of rows[z]
+    };
+    using Plane = std::array<Layer, CHUNK_HEIGHT>;
+
+    struct Emitter {
+        int index; // lightMap index
+        int level;
+    };
+
+    Plane m_Transparent;
+    Plane m_Lit; // voxels lit at or above the level being propagated
+    Plane m_Added; // voxels reached by the current step
+    std::array<bool, CHUNK_HEIGHT> m_Changed; // layers that gained voxels in the previous step
+    std::vector<Emitter> m_Emitters; // brightest first
+    size_t m_NextEmitter = 0; // first emitter not seeded yet
+
+    void buildMasks(const ChunkComponent& chunkComp);
+    void seedSunlight(ChunkComponent& chunkComp);
+    void seedEmitters(ChunkComponent& chunkComp, int level);
+    // runs the steps from fromLevel - 1 down to 1, m_Lit and m_Changed hold the voxels seeded at fromLevel
+    void propagate(ChunkComponent& chunkComp, int fromLevel, int channelShift);
+    // m_Added[y] = voxels of layer y the current step lights, returns whether there are any
+    bool growLayer(int y);
+    static void writeLevel(ChunkComponent& chunkComp, const Layer& voxels, int y, int level, int channelShift);
+};
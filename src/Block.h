@@ -21,7 +21,8 @@ enum BlockType // : uint8_t
     COBBLESTONE = 14*16 + 0,
     SAND = 14*16 + 2,
     WOOL_YELLOW = 5*16 + 2,
-    LADDER = 10*16 + 3
+    LADDER = 10*16 + 3,
+    GLOWSTONE = 9*16 + 9
 };
 
 // current dim scheme (face = 0 through 5)
@@ -44,15 +45,19 @@ private:
     const BlockType type;
     const std::array<BlockType, 6> sides;
     const bool transparent;
+    const int emission; // torchlight level emitted by the block, 0 if it gives no light
     const std::string typeName;
 public:
-    Block(const BlockType type, const bool trans, const std::string name)
-            : type(type), sides(sidesByType(type)), transparent(trans), typeName(name) {}
+    Block(const BlockType type, const bool trans, const int emission, const std::string name)
+            : type(type), sides(sidesByType(type)), transparent(trans), emission(emission), typeName(name) {}
     Block() = delete;
 
     const bool isTransparent() const {
         return transparent;
     };
+    const int lightEmission() const {
+        return emission;
+    }
     const BlockType sideAtDir(Direction dir) const {
         return sides[static_cast<int>(dir)];
     }
@@ -62,21 +67,24 @@ public:
 };
 
 struct blockData {
-    blockData(const BlockType t, const bool ts, const std::string n)
-    :   type(t), transparencyStatus(ts), name(n) {}
+    blockData(const BlockType t, const bool ts, const int e, const std::string n)
+    :   type(t), transparencyStatus(ts), emission(e), name(n) {}
     const BlockType type;
     const bool transparencyStatus;
+    const int emission;
     const std::string name;
 };
 
-static std::list<const blockData> activeBlockRegistry {
-        {AIR, true, "Air"},
-        {STONE, false, "Stone"},
-        {GRASS, false, "Grass"},
-        {COBBLESTONE, false, "Cobblestone"},
-        {SAND, false, "Sand"},
-        {WOOL_YELLOW, false, "Yellow Wool"},
-        {LADDER, false, "Ladder"},
+// type, transparent, light emission (0-15), name
+static const std::list<blockData> activeBlockRegistry {
+        {AIR, true, 0, "Air"},
+        {STONE, false, 0, "Stone"},
+        {GRASS, false, 0, "Grass"},
+        {COBBLESTONE, false, 0, "Cobblestone"},
+        {SAND, false, 0, "Sand"},
+        {WOOL_YELLOW, false, 0, "Yellow Wool"},
+        {LADDER, false, 0, "Ladder"},
+        {GLOWSTONE, false, 15, "Glowstone"},
 };
 
 // WEST = -1, EAST = +1
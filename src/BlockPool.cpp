@@ -6,8 +6,8 @@ std::array<const Block*, TOTAL_BLOCK_TYPES> BlockPool::blockPtrs;
 BlockPool::BlockPool()
 {
     // create an instance of each object & store pointer
-    for (auto& [type, isTransparent, name] : activeBlockRegistry)
-        BlockPool::blockPtrs[static_cast<int>(type)] = new Block(type, isTransparent, name);
+    for (auto& [type, isTransparent, emission, name] : activeBlockRegistry)
+        BlockPool::blockPtrs[static_cast<int>(type)] = new Block(type, isTransparent, emission, name);
 }
 
 BlockPool::~BlockPool() {
@@ -19,7 +19,3 @@ const BlockPool& BlockPool::getPoolInstance() {
     static BlockPool bp;
     return bp;
 }
-
-const Block* BlockPool::getBlockPtr(const BlockType type) const {
-    return BlockPool::blockPtrs[static_cast<int>(type)];
-}
\ No newline at end of file
@@ -13,7 +13,9 @@ private:
     ~BlockPool();
 public:
     static const BlockPool& getPoolInstance();
-    const Block* getBlockPtr(const BlockType type) const;
+    const Block* getBlockPtr(const BlockType type) const {
+        return BlockPool::blockPtrs[static_cast<int>(type)];
+    }
 
     BlockPool operator=(const BlockPool& bp) = delete; // singleton: disallow copies
     BlockPool operator=(BlockPool&&) = delete;
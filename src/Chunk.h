@@ -2,3 +2,9 @@
 
 const int CHUNK_WIDTH = 16;
 const int CHUNK_HEIGHT = 128;
+const int CHUNK_VOLUME = CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_WIDTH;
+
+// chunks are split vertically into cubic sections
+const int SECTION_HEIGHT = CHUNK_WIDTH;
+const int CHUNK_SECTIONS = CHUNK_HEIGHT / SECTION_HEIGHT;
+const int SECTION_VOLUME = CHUNK_WIDTH * SECTION_HEIGHT * CHUNK_WIDTH;
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <glm/vec3.hpp>
+#include <entt/entt.hpp>
+#include "Block.h"
+#include "Chunk.h"
+#include "Biome.h"
+#include "BlockPool.h"
+#include "ChunkSection.h"
+
+// stages a chunk passes through in order, a stage is only scheduled once its neighbours are far enough along
+enum class ChunkStatus : uint8_t {
+    EMPTY, // allocated, no blocks yet
+    TERRAIN, // base terrain and biome toppers placed
+    DECORATED, // cross-chunk features placed (none yet)
+    LIT, // light map matches blocks
+    MESHED, // vertices built, requires itself and all four neighbours LIT
+    UPLOADED // vertices sent to the chunk's VBO
+};
+
+// std::atomic is neither copyable nor movable, but entt relocates components when others are erased
+// relocation only happens on the main thread while no job holds the chunk
+struct AtomicChunkStatus {
+    std::atomic<ChunkStatus> value {ChunkStatus::EMPTY};
+
+    AtomicChunkStatus() = default;
+    AtomicChunkStatus(AtomicChunkStatus&& other) noexcept
+        : value(other.value.load(std::memory_order_relaxed)) {}
+    AtomicChunkStatus& operator=(AtomicChunkStatus&& other) noexcept {
+        value.store(other.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+};
+
+// block, biome and light data of one chunk; kept free of OpenGL so it can be generated headless
+struct ChunkComponent
+{
+private:
+    AtomicChunkStatus currentStatus; // advanced by worker jobs, read by the main thread when scheduling
+    uint8_t dirtySectionMask = (1 << CHUNK_SECTIONS) - 1; // bit per section whose mesh is out of date, main thread only
+    std::array<ChunkSection, CHUNK_SECTIONS> sections; // bottom to top, palette-compressed
+    // per x,z column: one above the highest opaque block, everything from there up sees the sky
+    std::array<uint8_t, CHUNK_WIDTH * CHUNK_WIDTH> heightMap {};
+
+    void updateColumnHeight(int x, int z, int yTop) {
+        int y = yTop;
+        while (y >= 0 && blockAt(x, y, z)->isTransparent())
+            y--;
+        heightMap[x + z * CHUNK_WIDTH] = static_cast<uint8_t>(y + 1);
+    }
+
+public:
+    ChunkStatus status() const {
+        return currentStatus.value.load(std::memory_order_acquire);
+    }
+    bool hasReached(ChunkStatus stage) const {
+        return status() >= stage;
+    }
+    // release pairs with status(): whoever sees the new stage also sees the data written for it
+    void setStatus(ChunkStatus stage) {
+        currentStatus.value.store(stage, std::memory_order_release);
+    }
+
+    // "points" to neighboring chunks, but not necessary to use pointers as entities are just integers
+    // convention: indexed with [NORTH, SOUTH, WEST, EAST] per enum
+    std::vector<entt::entity> neighborEntities {entt::null, entt::null, entt::null, entt::null};
+
+    // include array of 8 bit enums corresponding to block types
+    // classifies biome for each x,z index
+    std::vector<BiomeType> biomeMap; // = std::vector<BiomeType>(CHUNK_WIDTH * CHUNK_WIDTH, GrassBiome);
+
+    // reference to pointer to constant block
+    const Block* blockAt(int x, int y, int z) const {
+        return BlockPool::getPoolInstance().getBlockPtr(typeAt(x, y, z));
+    }
+    const Block* blockAt(const glm::ivec3& blockPos) const {
+        return blockAt(blockPos.x, blockPos.y, blockPos.z);
+    }
+    BlockType typeAt(int x, int y, int z) const {
+        return sections[y / SECTION_HEIGHT].typeAt(x, y % SECTION_HEIGHT, z);
+    }
+
+    void setBlock(std::array<ChunkSection, CHUNK_SECTIONS>&& chunkSections) {
+        sections = std::move(chunkSections);
+        for (ChunkSection& section : sections) // collapse all-air/single-type sections to a flag
+            section.compact();
+
+        // all-air sections at the top can't hold the highest opaque block, start scanning below them
+        int sectionIdx = CHUNK_SECTIONS;
+        while (sectionIdx > 0 && sections[sectionIdx - 1].isEmpty())
+            sectionIdx--;
+        for (int z = 0; z < CHUNK_WIDTH; z++)
+            for (int x = 0; x < CHUNK_WIDTH; x++)
+                updateColumnHeight(x, z, sectionIdx * SECTION_HEIGHT - 1);
+    }
+    void setBlock(const glm::ivec3& blockPos, const BlockType type) {
+        if (typeAt(blockPos.x, blockPos.y, blockPos.z) == type) // avoid meshing/lighting again if no changes
+            return;
+
+        sections[blockPos.y / SECTION_HEIGHT].setBlock(blockPos.x, blockPos.y % SECTION_HEIGHT, blockPos.z, type);
+        uint8_t& height = heightMap[blockPos.x + blockPos.z * CHUNK_WIDTH];
+        if (not BlockPool::getPoolInstance().getBlockPtr(type)->isTransparent())
+            height = std::max<uint8_t>(height, blockPos.y + 1);
+        else if (blockPos.y + 1 == height) // top of the column removed, find the next opaque block below
+            updateColumnHeight(blockPos.x, blockPos.z, blockPos.y - 1);
+        // light is kept up to date incrementally by LightEngine::updateBlockLight, only the mesh is stale
+        markSectionsDirty(blockPos.y);
+    }
+
+    // sections that need remeshing before the chunk is drawn again, all of them until first meshed
+    uint8_t dirtySections() const {
+        return dirtySectionMask;
+    }
+    // the meshes of the section holding layer y and of the one across a section boundary at y both see its voxels;
+    // a meshed chunk drops back to LIT so ChunkMeshingSystem rebuilds them
+    void markSectionsDirty(int y) {
+        dirtySectionMask |= 1 << (y / SECTION_HEIGHT);
+        if (y % SECTION_HEIGHT == 0 && y > 0)
+            dirtySectionMask |= 1 << (y / SECTION_HEIGHT - 1);
+        else if (y % SECTION_HEIGHT == SECTION_HEIGHT - 1 && y < CHUNK_HEIGHT - 1)
+            dirtySectionMask |= 1 << (y / SECTION_HEIGHT + 1);
+        if (hasReached(ChunkStatus::MESHED))
+            setStatus(ChunkStatus::LIT);
+    }
+    void clearDirtySections(uint8_t sections) {
+        dirtySectionMask &= ~sections;
+    }
+    const ChunkSection& sectionAt(int sectionIdx) const {
+        return sections[sectionIdx];
+    }
+    // lowest y of the column with direct sky access (0 if the column holds no opaque block)
+    int skyHeight(int x, int z) const {
+        return heightMap[x + z * CHUNK_WIDTH];
+    }
+
+    // sunlight corresponds to the bits 0000XXXX
+    // torchlight corresponds to bits XXXX0000
+    std::vector<uint8_t> lightMap = std::vector<uint8_t>(CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_WIDTH, 0);
+    void clearLightMap() {
+        memset(&lightMap[0], static_cast<uint8_t>(0), lightMap.size());
+    }
+    // sets sunlight of every voxel in layers [yBegin, yEnd) at once, torchlight is preserved
+    void fillSunlight(int yBegin, int yEnd, int val) {
+        for (int i = yBegin * CHUNK_WIDTH * CHUNK_WIDTH; i < yEnd * CHUNK_WIDTH * CHUNK_WIDTH; i++)
+            lightMap[i] = (lightMap[i] & 0xF0) | val;
+    }
+    int getSunlight(int x, int y, int z) {
+        return lightMap[x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH)] & 0xF;
+    }
+    void setSunlight(int x, int y, int z, int val) {
+        lightMap[x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH)]
+                = (lightMap[x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH)] & 0xF0) | val;
+    }
+    int getTorchlight(int x, int y, int z) {
+        return (lightMap[x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH)] >> 4) & 0xF;
+    }
+    void setTorchlight(int x, int y, int z, int val) {
+        lightMap[x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH)]
+                = (lightMap[x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH)] & 0xF) | (val << 4);
+    }
+    uint8_t lightAt(int x, int y, int z) {
+        return lightMap[x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH)];
+    }
+};
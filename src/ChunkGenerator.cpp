@@ -1,149 +1,119 @@
 
 #include "ChunkGenerator.h"
-#include "Components.h"
-#include "Debug.h"
-//#include <glad.h>
+#include <algorithm>
 #include <iostream>
 #include <queue>
 
-ChunkGenerator::ChunkGenerator(int seed, entt::registry& registry, ChunkMapComponent& chunkMap)
-    : m_Seed(seed), m_Registry(registry), m_BlockPool(BlockPool::getPoolInstance()), m_ChunkMap(chunkMap)
+ChunkGenerator::ChunkGenerator(int seed)
+    : m_Seed(seed), m_BlockPool(BlockPool::getPoolInstance()),
+    // NOTE: equal seeds make temperature == precipitation everywhere, so SandBiome never occurs (kept as-is for now)
+    m_BiomeSampler(seed, seed), m_RegionCache(cachedRegions, [this](const glm::vec3& chunkPos, TerrainColumns& columns) {
+        generateTerrainColumns(chunkPos, columns);
+    })
 {
-    terrainBaseNoise.SetSeed(m_Seed);
-    terrainBaseNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    terrainBaseNoise.SetFractalType(FastNoiseLite::FractalType_FBm);
-    terrainBaseNoise.SetFrequency(0.00522f);
-    terrainBaseNoise.SetFractalOctaves(16);
-    // terrainBaseNoise.SetFractalGain();
-    terrainBaseNoise.SetFractalLacunarity(1.0f);
-
-    biomeTopNoise.SetSeed(m_Seed);
-    biomeTopNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    biomeTopNoise.SetFractalType(FastNoiseLite::FractalType_FBm);
-    biomeTopNoise.SetFrequency(0.00781f);
-    biomeTopNoise.SetFractalOctaves(4);
-    // biomeTopNoise.SetFractalGain();
-    biomeTopNoise.SetFractalLacunarity(2.333f);
-
-    temperatureNoise.SetSeed(m_Seed);
-    temperatureNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    temperatureNoise.SetFrequency(0.0008);
-    precipitationNoise.SetSeed(m_Seed);
-    precipitationNoise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
-    precipitationNoise.SetFrequency(0.0008);
+    terrainBaseNoise.setSeed(m_Seed);
+    terrainBaseNoise.setFractalType(FastNoiseLite::FractalType_FBm);
+    terrainBaseNoise.setFrequency(0.00522f);
+    terrainBaseNoise.setFractalOctaves(16);
+    // terrainBaseNoise.setFractalGain();
+    terrainBaseNoise.setFractalLacunarity(1.0f);
+
+    biomeTopNoise.setSeed(m_Seed);
+    biomeTopNoise.setFractalType(FastNoiseLite::FractalType_FBm);
+    biomeTopNoise.setFrequency(0.00781f);
+    biomeTopNoise.setFractalOctaves(4);
+    // biomeTopNoise.setFractalGain();
+    biomeTopNoise.setFractalLacunarity(2.333f);
+
 }
 
 ChunkGenerator::~ChunkGenerator()
 {}
 
-void ChunkGenerator::createChunkComponent(const entt::entity& e_Chunk, glm::vec3 chunkPos) {
-    ChunkComponent& chunkComp = m_Registry.get<ChunkComponent>(e_Chunk);
-    chunkComp.biomeMap = generateBiomeMap(chunkPos);
-    createChunkBlocks(chunkComp, chunkPos, chunkComp.biomeMap);
-    updateLightMap(chunkComp);
-}
-
-// creates entity and attaches components (note: does not populate component data)
-const entt::entity ChunkGenerator::generateChunkEntity(const glm::vec3& chunkPos)
-{
-    const entt::entity e_Chunk = m_Registry.create();
-    m_Registry.emplace<PositionComponent>(e_Chunk, chunkPos);
-
-    unsigned int chunkVBO;
-    glGenBuffers(1, &chunkVBO);
-
-    std::vector<texArrayVertex> chunkVertices; // uninitialized, marked for update
-    // std::move required for OpenGL ownership
-    m_Registry.emplace<MeshComponent>(e_Chunk, true, std::move(chunkVBO), chunkVertices);
-
-    ChunkComponent chunkComp;
-    m_Registry.emplace<ChunkComponent>(e_Chunk, chunkComp);
-    m_ChunkMap.insertChunk(e_Chunk, std::make_pair(chunkPos.x, chunkPos.z));
-
-    return e_Chunk;
+std::unique_ptr<ChunkPayload> ChunkGenerator::generateChunkData(const glm::vec3& chunkPos) {
+    auto payload = std::make_unique<ChunkPayload>();
+    payload->chunkPos = chunkPos;
+    ChunkComponent& chunkComp = payload->chunk;
+    TerrainColumns columns = m_RegionCache.columnsOf(chunkPos);
+    chunkComp.biomeMap.assign(columns.biome.begin(), columns.biome.end());
+    createChunkBlocks(chunkComp, columns);
+    chunkComp.setStatus(ChunkStatus::TERRAIN);
+    // no features cross chunk borders yet (trees, ores), so decoration needs no neighbours and places nothing
+    chunkComp.setStatus(ChunkStatus::DECORATED);
+    // the chunk is lit on its own here (no neighbours on a worker thread),
+    // LightEngine::stitchChunk exchanges light across its borders once ChunkLoaderSystem commits it
+    updateLightMap(chunkComp, m_LightPropagation);
+    chunkComp.setStatus(ChunkStatus::LIT);
+    return payload;
 }
 
-void ChunkGenerator::createChunkBlocks(ChunkComponent& chunkComp, const glm::vec3& chunkPos,
-                                       const std::vector<BiomeType>& biomeMap)
+void ChunkGenerator::createChunkBlocks(ChunkComponent& chunkComp, const TerrainColumns& columns)
 {
-    std::vector<const Block*> blocks(CHUNK_WIDTH*CHUNK_HEIGHT*CHUNK_WIDTH, m_BlockPool.getBlockPtr(AIR));
-    std::vector<int> baseHeightmap = generateBaseHeightmap(chunkPos);
-    std::vector<int> biomeTop = generateBiomeTopHeightmap(chunkPos);
+    std::array<ChunkSection, CHUNK_SECTIONS> sections;
+    const auto& baseHeightmap = columns.baseHeight;
+    const auto& biomeTop = columns.biomeTopHeight;
 
     for (int z = 0; z < CHUNK_WIDTH; z++) {
         for (int x = 0; x < CHUNK_WIDTH; x++) {
             int y = 0;
             for (; y < baseHeightmap[x + z * CHUNK_WIDTH]; y++) {
-                blocks[x + z * CHUNK_WIDTH + y * CHUNK_WIDTH * CHUNK_WIDTH] = m_BlockPool.getBlockPtr(STONE);
+                sections[y / SECTION_HEIGHT].setBlock(x, y % SECTION_HEIGHT, z, STONE);
             }
 
-            BlockType biomeBlock = biomeTopBlockLookup(biomeMap[x + z * CHUNK_WIDTH]);
+            BlockType biomeBlock = biomeTopBlockLookup(columns.biome[x + z * CHUNK_WIDTH]);
             for (int topperHeight = 0; topperHeight < biomeTop[x + z * CHUNK_WIDTH]; topperHeight++) {
-                blocks[x + z * CHUNK_WIDTH + (y + topperHeight) * CHUNK_WIDTH * CHUNK_WIDTH]
-                                                        = m_BlockPool.getBlockPtr(biomeBlock);
+                int topperY = y + topperHeight;
+                sections[topperY / SECTION_HEIGHT].setBlock(x, topperY % SECTION_HEIGHT, z, biomeBlock);
             }
         }
     }
 
-    chunkComp.setBlock(blocks);
+    chunkComp.setBlock(std::move(sections));
 }
 
-BiomeType ChunkGenerator::biomeLookup(float temperature, float precipitation) {
-    if (temperature > 0.8f && precipitation < 0.2f)
-        return SandBiome;
-
-    return GrassBiome;
+void ChunkGenerator::generateTerrainColumns(const glm::vec3& chunkPos, TerrainColumns& columns) const
+{
+    generateBaseHeightmap(chunkPos, columns);
+    generateBiomeTopHeightmap(chunkPos, columns);
+    generateBiomeMap(chunkPos, columns);
 }
 
-std::vector<BiomeType> ChunkGenerator::generateBiomeMap(glm::vec3 chunkPos) {
-    std::vector<BiomeType> biomeMap(CHUNK_WIDTH * CHUNK_WIDTH);
-    float temperature;
-    float precipitation;
-    auto scale = [](float val) { return (val + 1.0f)/2.0f; };
-
-    for (int z = 0; z < CHUNK_WIDTH; z++)
-        for (int x = 0; x < CHUNK_WIDTH; x++)
-        {
-            temperature = scale(temperatureNoise.GetNoise(chunkPos.x + x, chunkPos.z + z));
-            precipitation = scale(precipitationNoise.GetNoise(chunkPos.x + x, chunkPos.z + z));
-            // also include elevation? idts it changes too fast
-            biomeMap[x + z * CHUNK_WIDTH] = biomeLookup(temperature, precipitation);
-        }
-
-    return biomeMap;
+void ChunkGenerator::generateBiomeMap(glm::vec3 chunkPos, TerrainColumns& columns) const {
+    // temperature/precipitation vary over thousands of blocks, the coarse lattice keeps the same boundaries
+    m_BiomeSampler.sampleCoarse(chunkPos, columns.biome);
 }
 
-std::vector<int> ChunkGenerator::generateBaseHeightmap(glm::vec3 chunkPos)
+void ChunkGenerator::generateBaseHeightmap(glm::vec3 chunkPos, TerrainColumns& columns) const
 {
-    std::vector<int> baseHeightmap(CHUNK_WIDTH*CHUNK_WIDTH, 0);
-
     // lambda scales noise to desired range: [minBaseHeight, maxBaseHeight]
     auto scale = [this](float val) { return static_cast<int>((val + 1.0)*(maxBaseHeight-minBaseHeight)/2.0 + minBaseHeight); };
 
-    for (int z = 0; z < CHUNK_WIDTH; z++)
-        for (int x = 0; x < CHUNK_WIDTH; x++)
-            baseHeightmap[x + z*CHUNK_WIDTH] =
-                    scale(terrainBaseNoise.GetNoise((float) (x + chunkPos.x), (float) (z + chunkPos.z)));
-
-    return baseHeightmap;
+    float noise[CHUNK_WIDTH * CHUNK_WIDTH];
+    terrainBaseNoise.getNoiseTile(chunkPos.x, chunkPos.z, CHUNK_WIDTH, CHUNK_WIDTH, noise);
+    for (int i = 0; i < CHUNK_WIDTH * CHUNK_WIDTH; i++)
+        columns.baseHeight[i] = scale(noise[i]);
 }
 
-std::vector<int> ChunkGenerator::generateBiomeTopHeightmap(glm::vec3 chunkPos)
+void ChunkGenerator::generateBiomeTopHeightmap(glm::vec3 chunkPos, TerrainColumns& columns) const
 {
-    std::vector<int> biomeTopHeightmap(CHUNK_WIDTH*CHUNK_WIDTH, 0);
-
     // lambda scales noise to desired range: [minBaseHeight, maxBaseHeight]
     auto scale = [this](float val) { return static_cast<int>((val + 1.0)*(maxBiomeHeight-minBiomeHeight)/2.0 + minBiomeHeight); };
 
-    for (int z = 0; z < CHUNK_WIDTH; z++)
-        for (int x = 0; x < CHUNK_WIDTH; x++)
-            biomeTopHeightmap[x + z*CHUNK_WIDTH] =
-                    scale(biomeTopNoise.GetNoise((float) (x + chunkPos.x), (float) (z + chunkPos.z)));
+    float noise[CHUNK_WIDTH * CHUNK_WIDTH];
+    biomeTopNoise.getNoiseTile(chunkPos.x, chunkPos.z, CHUNK_WIDTH, CHUNK_WIDTH, noise);
+    for (int i = 0; i < CHUNK_WIDTH * CHUNK_WIDTH; i++)
+        columns.biomeTopHeight[i] = scale(noise[i]);
+}
 
-    return biomeTopHeightmap;
+void ChunkGenerator::updateLightMap(ChunkComponent& chunkComp, LightPropagation method)
+{
+    if (method == LightPropagation::BIT_PLANES)
+        BitLightPropagator::updateLightMap(chunkComp);
+    else
+        updateLightMapBreadthFirst(chunkComp);
 }
 
-void ChunkGenerator::updateLightMap(ChunkComponent& chunkComp) {
+void ChunkGenerator::updateLightMapBreadthFirst(ChunkComponent& chunkComp) {
     // TODO: include entt::entity and update bounds checking to support cross-voxel light flooding
     struct lightNode {
         int x, y, z, lightLevel;
@@ -154,19 +124,36 @@ void ChunkGenerator::updateLightMap(ChunkComponent& chunkComp) {
     chunkComp.clearLightMap();
     std::queue<lightNode> q;
 
-    // flood fill sunlight from the top of the chunk
-    // all voxels with direct vertical access to top of chunk are source nodes
-    for (int x = 0; x < CHUNK_WIDTH; x++)
-        for (int z = 0; z < CHUNK_WIDTH; z++)
+    // everything at or above a column's heightmap entry sees the sky: fill it without queueing
+    // layers above the tallest column are written in bulk, the rest column by column
+    int minHeight = CHUNK_HEIGHT, maxHeight = 0;
+    for (int z = 0; z < CHUNK_WIDTH; z++)
+        for (int x = 0; x < CHUNK_WIDTH; x++)
         {
-            int y = CHUNK_HEIGHT - 1;
-            // propagates through transparent/air blocks
-            while (y >= 0 && chunkComp.blockAt(x, y, z)->isTransparent())
+            minHeight = std::min(minHeight, chunkComp.skyHeight(x, z));
+            maxHeight = std::max(maxHeight, chunkComp.skyHeight(x, z));
+        }
+    chunkComp.fillSunlight(maxHeight, CHUNK_HEIGHT, 15);
+    for (int z = 0; z < CHUNK_WIDTH; z++)
+        for (int x = 0; x < CHUNK_WIDTH; x++)
+            for (int y = chunkComp.skyHeight(x, z); y < maxHeight; y++)
+                chunkComp.setSunlight(x, y, z, 15);
+
+    // only sky voxels beside a taller column can light anything: the voxel below is opaque, above is sky,
+    // and a neighbour at the same y is either sky as well or lies in the shadow of that taller column
+    for (int z = 0; z < CHUNK_WIDTH; z++)
+        for (int x = 0; x < CHUNK_WIDTH; x++)
+        {
+            int frontierTop = chunkComp.skyHeight(x, z);
+            for (int dir = 0; dir < 4; dir++)
             {
-                chunkComp.setSunlight(x, y, z, 15); // max light value = 15
-                q.emplace(x, y, z, 15);
-                y--;
+                int neighborX = x + deltaXByDir[dir];
+                int neighborZ = z + deltaZByDir[dir];
+                if (neighborX >= 0 && neighborX < CHUNK_WIDTH && neighborZ >= 0 && neighborZ < CHUNK_WIDTH)
+                    frontierTop = std::max(frontierTop, chunkComp.skyHeight(neighborX, neighborZ));
             }
+            for (int y = chunkComp.skyHeight(x, z); y < frontierTop; y++)
+                q.emplace(x, y, z, 15);
         }
 
     // BFS to flood fill sunlight
@@ -196,6 +183,50 @@ void ChunkGenerator::updateLightMap(ChunkComponent& chunkComp) {
 
     }
 
+    // torchlight: separate BFS seeded only at emissive blocks, so it stays within their light radius
+    // sections whose palette holds no emitter are skipped without looking at their voxels
+    const BlockPool& blockPool = BlockPool::getPoolInstance();
+    for (int sectionIdx = 0; sectionIdx < CHUNK_SECTIONS; sectionIdx++)
+    {
+        const ChunkSection& section = chunkComp.sectionAt(sectionIdx);
+        const std::vector<BlockType>& palette = section.storage().palette();
+        if (std::none_of(palette.begin(), palette.end(), [&blockPool](BlockType type) {
+                return blockPool.getBlockPtr(type)->lightEmission() > 0; }))
+            continue;
+        for (int y = sectionIdx * SECTION_HEIGHT; y < (sectionIdx + 1) * SECTION_HEIGHT; y++)
+            for (int z = 0; z < CHUNK_WIDTH; z++)
+                for (int x = 0; x < CHUNK_WIDTH; x++)
+                {
+                    int emission = chunkComp.blockAt(x, y, z)->lightEmission();
+                    if (emission == 0)
+                        continue;
+                    chunkComp.setTorchlight(x, y, z, emission);
+                    q.emplace(x, y, z, emission);
+                }
+    }
+
+    while (!q.empty())
+    {
+        lightNode curNode = q.front();
+        q.pop();
+
+        for (int dir = 0; dir < 6; dir++)
+        {
+            int neighborX = curNode.x + deltaXByDir[dir];
+            int neighborY = curNode.y + deltaYByDir[dir];
+            int neighborZ = curNode.z + deltaZByDir[dir];
+            if (neighborX < 0 || neighborX >= CHUNK_WIDTH || neighborY < 0 || neighborY >= CHUNK_HEIGHT
+                || neighborZ < 0 || neighborZ >= CHUNK_WIDTH)
+                continue; // out of bounds, LightEngine carries it across chunk borders
+            if (not chunkComp.blockAt(neighborX, neighborY, neighborZ)->isTransparent())
+                continue;
+
+            if (chunkComp.getTorchlight(neighborX, neighborY, neighborZ) < curNode.lightLevel - 1) {
+                chunkComp.setTorchlight(neighborX, neighborY, neighborZ, curNode.lightLevel - 1);
+                q.emplace(neighborX, neighborY, neighborZ, curNode.lightLevel - 1);
+            }
+        }
+    }
 }
 
 
@@ -3,44 +3,68 @@
 #include <vector>
 
 #include <glm/vec3.hpp>
-#include <FastNoiseLite/FastNoiseLite.h>
-#include <entt/entt.hpp>
 #include <memory>
 
 #include "Chunk.h"
 #include "Block.h"
-#include "Components.h"
+#include "ChunkComponent.h"
 #include "Biome.h"
 #include "BlockPool.h"
+#include "GridNoise.h"
+#include "BiomeSampler.h"
+#include "TerrainRegionCache.h"
+#include "BitLightPropagator.h"
+
+// self-contained result of generating one chunk (blocks, biome map, light), built off the main thread
+// ChunkLoaderSystem turns it into an entity, tools/pregen writes it to disk
+struct ChunkPayload
+{
+    glm::vec3 chunkPos;
+    ChunkComponent chunk;
+};
+
+// how updateLightMap floods light through a chunk, both produce identical light maps
+enum class LightPropagation {
+    BREADTH_FIRST, // one voxel at a time through a queue
+    BIT_PLANES // whole 16x16 layers at a time, see BitLightPropagator
+};
 
 class ChunkGenerator {
 public:
-    ChunkGenerator(int seed, entt::registry& registry, ChunkMapComponent& chunkMap);
+    explicit ChunkGenerator(int seed);
     ~ChunkGenerator();
 
-    const entt::entity generateChunkEntity(const glm::vec3& chunkPos);
-    void generateChunk(glm::vec3 chunkPos);
-    static void updateLightMap(ChunkComponent& chunkComp);
-    void createChunkComponent(const entt::entity& e_Chunk, glm::vec3 chunkPos);
+    // pure chunk data (no registry, no OpenGL), safe to call from worker threads
+    std::unique_ptr<ChunkPayload> generateChunkData(const glm::vec3& chunkPos);
+    // the noise-derived columns generateChunkData places blocks from, served by the region cache
+    TerrainColumns terrainColumnsOf(const glm::vec3& chunkPos) { return m_RegionCache.columnsOf(chunkPos); }
+    const TerrainRegionCache& regionCache() const { return m_RegionCache; }
+    static void updateLightMap(ChunkComponent& chunkComp, LightPropagation method = LightPropagation::BIT_PLANES);
+    void setLightPropagation(LightPropagation method) { m_LightPropagation = method; }
 
 private:
     const int m_Seed;
-    entt::registry& m_Registry;
     const BlockPool& m_BlockPool;
-    ChunkMapComponent& m_ChunkMap;
+    LightPropagation m_LightPropagation = LightPropagation::BIT_PLANES;
 
-    void createChunkBlocks(ChunkComponent& chunkComp, const glm::vec3& chunkPos, const std::vector<BiomeType>& biomeMap);
-    std::vector<int> generateBaseHeightmap(glm::vec3 chunkPos);
-    std::vector<int> generateBiomeTopHeightmap(glm::vec3 chunkPos);
+    void createChunkBlocks(ChunkComponent& chunkComp, const TerrainColumns& columns);
+    // fills all noise-derived columns of a chunk, called by m_RegionCache on a miss
+    void generateTerrainColumns(const glm::vec3& chunkPos, TerrainColumns& columns) const;
+    void generateBaseHeightmap(glm::vec3 chunkPos, TerrainColumns& columns) const;
+    void generateBiomeTopHeightmap(glm::vec3 chunkPos, TerrainColumns& columns) const;
     // how to store biome? pointer? to singleton? enum?
-    std::vector<BiomeType> generateBiomeMap(glm::vec3 chunkPos);
-    BiomeType biomeLookup(float temperature, float precipitation);
+    void generateBiomeMap(glm::vec3 chunkPos, TerrainColumns& columns) const;
+    static void updateLightMapBreadthFirst(ChunkComponent& chunkComp);
 //    void generateFlora(std::vector<BlockType> blocks);
 
-    FastNoiseLite terrainBaseNoise;
-    FastNoiseLite biomeTopNoise;
-    FastNoiseLite temperatureNoise;
-    FastNoiseLite precipitationNoise;
+    // noise is sampled one 16x16 tile per chunk (SIMD), matching FastNoiseLite::GetNoise exactly
+    GridNoise terrainBaseNoise;
+    GridNoise biomeTopNoise;
+    BiomeSampler m_BiomeSampler; // coarse temperature/precipitation lattice
+
+    // 3x3 regions around the player (1536 blocks square), revisited chunks skip noise entirely
+    static const size_t cachedRegions = 9;
+    TerrainRegionCache m_RegionCache;
 
     // maxBase + maxBiome + anything on top must be less than CHUNK_HEIGHT
     const int minBaseHeight = 60; // bounds stone
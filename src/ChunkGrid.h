@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <entt/entt.hpp>
+#include "Chunk.h"
+
+// toroidal (ring buffer) grid of chunk handles, slot = (chunkX mod SIZE, chunkZ mod SIZE)
+// any SIZE x SIZE square of chunks maps onto distinct slots, so a player-centred window needs no hashing
+// each slot remembers its chunk position, letting stale/foreign occupants be detected on lookup
+class ChunkGrid {
+public:
+    static const int SIZE = 32; // power of two, must cover the widest loaded window (in chunks)
+
+    ChunkGrid() {
+        for (Slot& slot : m_Slots)
+            slot = Slot();
+    }
+
+    // chunk positions are world block coordinates of the chunk corner (multiples of CHUNK_WIDTH)
+    entt::entity find(int x, int z) const {
+        const Slot& slot = m_Slots[slotOf(x, z)];
+        return (slot.x == x && slot.z == z) ? slot.entity : entt::null;
+    }
+    // entity occupying the slot of (x, z), which may belong to a different chunk (entt::null if free)
+    entt::entity occupant(int x, int z) const {
+        return m_Slots[slotOf(x, z)].entity;
+    }
+    void set(int x, int z, entt::entity e) {
+        m_Slots[slotOf(x, z)] = {x, z, e};
+    }
+    bool clear(int x, int z) {
+        Slot& slot = m_Slots[slotOf(x, z)];
+        if (slot.entity == entt::null || slot.x != x || slot.z != z)
+            return false;
+        slot = Slot();
+        return true;
+    }
+
+private:
+    struct Slot {
+        int x = 0, z = 0;
+        entt::entity entity = entt::null;
+    };
+    std::array<Slot, SIZE * SIZE> m_Slots;
+
+    static int slotOf(int x, int z) {
+        // chunk coordinates are exact multiples of CHUNK_WIDTH, & on two's complement wraps negatives correctly
+        return ((x / CHUNK_WIDTH) & (SIZE - 1)) + ((z / CHUNK_WIDTH) & (SIZE - 1)) * SIZE;
+    }
+};
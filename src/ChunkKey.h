@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstdint>
+
+// packs a pair of (chunk or region) coordinates into one 64 bit key for hashed containers
+inline uint64_t packChunkKey(int x, int z)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+}
@@ -1,74 +1,192 @@
 
 #include <algorithm>
 #include <stdlib.h>
-#include <thread>
 
 #include "ChunkLoaderSystem.h"
 
 #include "Chunk.h"
+#include "ChunkKey.h"
 #include "Block.h"
 #include "Components.h"
 #include "Player.h"
+#include "FrameBudget.h"
 
-ChunkLoaderSystem::ChunkLoaderSystem(entt::registry& registry, const int seed)
-    : m_Registry(registry), m_ChunkMap(createChunkMap(registry)),
-    m_ChunkGenerator(seed, registry, m_ChunkMap)
+ChunkLoaderSystem::ChunkLoaderSystem(entt::registry& registry, const int seed, JobSystem& jobSystem,
+                                     LightEngine& lightEngine)
+    : m_Registry(registry), m_JobSystem(jobSystem), m_LightEngine(lightEngine), m_ChunkMap(createChunkMap(registry)),
+    m_ChunkGenerator(seed)
 {}
 
 ChunkLoaderSystem::~ChunkLoaderSystem()
-{}
+{
+    // generation jobs reference the generator and completion queue, let them finish first
+    m_JobSystem.wait(m_GenerationJobs);
+}
 
 void ChunkLoaderSystem::update(entt::registry& registry) {
-    // TODO: maybe dont do this every frame? only if player leaves (cached) last chunk they were in
+    // finished chunks from previous frames enter the world first
+    commitGeneratedChunks(getFrameBudget(registry));
+
     // query for player location
-    // std::pair<int, int> playerChunk = getPlayerChunkLocation(m_Registry);
     std::pair<int, int> playerChunk = m_ChunkMap.chunkOf(getPlayerPos(registry));
+    glm::vec2 viewDir = horizontalViewDir(getPlayerCameraDir(registry));
+
+    // loaded area only changes when the player crosses a chunk border
+    if (not m_HasLoadedWindow || playerChunk != m_LastPlayerChunk)
+    {
+        updateLoadedWindow(playerChunk);
+        refreshChunkRequests(playerChunk, viewDir);
+        m_LastPlayerChunk = playerChunk;
+        m_HasLoadedWindow = true;
+    }
+    else if (glm::distance(viewDir, m_RequestViewDir) > 0.5f) // turned by roughly 30 degrees or more
+        refreshChunkRequests(playerChunk, viewDir);
 
-    std::vector<bool> nearbyChunks((2*chunkLoadDistance+1)*(2*chunkLoadDistance+1), false);
+    dispatchChunkRequests();
+}
 
-    // iterate through entities with chunkComponent in m_Registry
-        // UNLOAD_DISTANCE: delete out-of-range
-        // LOAD_DISTANCE: generate/load in-range if missing
-    auto chunkView = registry.view<ChunkComponent>();
-    for (const auto& e_Chunk : chunkView)
+void ChunkLoaderSystem::commitGeneratedChunks(FrameBudgetComponent& budget)
+{
+    BudgetTimer commitTimer(budget.commitBudgetMs);
+    std::unique_ptr<ChunkPayload> payload;
+    int committed = 0;
+    // at least one chunk per frame so streaming never stalls, remainder waits for the next frame
+    while ((committed == 0 || not commitTimer.exhausted()) && m_CompletedChunks.tryPop(payload))
     {
-        glm::vec3& chunkPos = registry.get<PositionComponent>(e_Chunk).pos;
-        int xDist = ((int)chunkPos.x - playerChunk.first) / CHUNK_WIDTH;
-        int zDist = ((int)chunkPos.z - playerChunk.second) / CHUNK_WIDTH;
-        int chunkDist = std::max(std::abs(xDist), std::abs(zDist));
+        m_ReadyChunks.fetch_sub(1, std::memory_order_relaxed);
+        std::pair<int, int> chunkLoc(payload->chunkPos.x, payload->chunkPos.z);
+        m_PendingChunks.erase(packChunkKey(chunkLoc.first, chunkLoc.second));
 
-        if (chunkDist >= chunkUnloadDistance) // delete from memory
-        {
-            destroyChunk(e_Chunk, chunkPos);
-        }
-        if (chunkDist <= chunkLoadDistance) // mark as present
-        {
-            // x + z*loadedChunkBoxSideLength but offset to avoid negative x/z distances
-            nearbyChunks[(xDist+chunkLoadDistance) + (zDist+chunkLoadDistance)*(2*chunkLoadDistance+1)] = true;
-        }
+        // player may have moved on while the chunk was generating
+        if (chunkDist(chunkLoc, m_LastPlayerChunk) >= chunkUnloadDistance)
+            continue;
+
+        commitChunk(std::move(*payload));
+        committed++;
+    }
+    budget.chunksCommitted = committed;
+    budget.commitsDeferred = m_ReadyChunks.load(std::memory_order_relaxed);
+}
+
+void ChunkLoaderSystem::updateLoadedWindow(const std::pair<int, int>& playerChunk)
+{
+    // UNLOAD_DISTANCE: every loaded chunk lies within the previous window, delete those now out-of-range
+    if (m_HasLoadedWindow)
+    {
+        for (int zOff = -(chunkUnloadDistance - 1); zOff <= chunkUnloadDistance - 1; zOff++)
+            for (int xOff = -(chunkUnloadDistance - 1); xOff <= chunkUnloadDistance - 1; xOff++)
+            {
+                std::pair<int, int> chunkLoc(m_LastPlayerChunk.first + xOff * CHUNK_WIDTH,
+                                             m_LastPlayerChunk.second + zOff * CHUNK_WIDTH);
+                if (chunkDist(chunkLoc, playerChunk) < chunkUnloadDistance)
+                    continue;
+                entt::entity e_Chunk = m_ChunkMap[chunkLoc];
+                if (e_Chunk != entt::null)
+                    destroyChunk(e_Chunk, glm::vec3(chunkLoc.first, 0, chunkLoc.second));
+            }
     }
 
-    // create any chunks missing within chunkLoadDistance
-    std::vector<std::thread> chunkGenThreads;
+    // LOAD_DISTANCE: request chunks in the new window that the previous window did not already cover
     for (int zOff = -chunkLoadDistance; zOff <= chunkLoadDistance; zOff++)
     {
         for (int xOff = -chunkLoadDistance; xOff <= chunkLoadDistance; xOff++)
         {
-            // xOff + zOff*loadedChunkBoxSideLength but offset to avoid negative x/z distances
-            if (not nearbyChunks[(xOff+chunkLoadDistance) + (zOff+chunkLoadDistance)*(2*chunkLoadDistance+1)])
-            {
-                int chunkX = playerChunk.first + xOff * CHUNK_WIDTH;
-                int chunkZ = playerChunk.second + zOff * CHUNK_WIDTH;
-                glm::vec3 chunkPos = glm::vec3(chunkX, 0, chunkZ);
-
-                const entt::entity e_Chunk = m_ChunkGenerator.generateChunkEntity(chunkPos);
-                chunkGenThreads.emplace_back(&ChunkGenerator::createChunkComponent, &m_ChunkGenerator, e_Chunk, chunkPos);
-            }
+            std::pair<int, int> chunkLoc(playerChunk.first + xOff * CHUNK_WIDTH,
+                                         playerChunk.second + zOff * CHUNK_WIDTH);
+            if (m_HasLoadedWindow && chunkDist(chunkLoc, m_LastPlayerChunk) <= chunkLoadDistance)
+                continue; // loaded (or generating) with the previous window
+            requestChunk(chunkLoc);
         }
     }
-    // safe for now: wait for all threads to complete before advancing to next system
-    for (std::thread& t : chunkGenThreads)
-        t.join();
+}
+
+void ChunkLoaderSystem::requestChunk(const std::pair<int, int>& chunkLoc)
+{
+    if (m_ChunkMap.isLoaded(chunkLoc)) // kept from an older window (within unload distance)
+        return;
+    if (not m_PendingChunks.insert(packChunkKey(chunkLoc.first, chunkLoc.second)).second)
+        return; // already queued or generating
+
+    // priority is assigned by refreshChunkRequests() once the whole window has been requested
+    m_ChunkRequests.push_back({0.0f, chunkLoc});
+}
+
+void ChunkLoaderSystem::refreshChunkRequests(const std::pair<int, int>& playerChunk, const glm::vec2& viewDir)
+{
+    // cancel requests that left the load window before a worker picked them up
+    auto outOfRange = [this, &playerChunk](const ChunkRequest& request) {
+        if (chunkDist(request.chunkLoc, playerChunk) <= chunkLoadDistance)
+            return false;
+        m_PendingChunks.erase(packChunkKey(request.chunkLoc.first, request.chunkLoc.second));
+        return true;
+    };
+    m_ChunkRequests.erase(std::remove_if(m_ChunkRequests.begin(), m_ChunkRequests.end(), outOfRange),
+                          m_ChunkRequests.end());
+
+    for (ChunkRequest& request : m_ChunkRequests)
+        request.priority = requestPriority(request.chunkLoc, playerChunk, viewDir);
+    std::make_heap(m_ChunkRequests.begin(), m_ChunkRequests.end());
+    m_RequestViewDir = viewDir;
+}
+
+void ChunkLoaderSystem::dispatchChunkRequests()
+{
+    // two jobs per worker keeps every worker busy between frames without committing to a stale order
+    const int maxJobsInFlight = 2 * static_cast<int>(m_JobSystem.workerCount());
+    while (not m_ChunkRequests.empty() && m_GenerationJobs.remaining.load() < maxJobsInFlight)
+    {
+        std::pop_heap(m_ChunkRequests.begin(), m_ChunkRequests.end());
+        std::pair<int, int> chunkLoc = m_ChunkRequests.back().chunkLoc;
+        m_ChunkRequests.pop_back();
+
+        // generation runs across frames on the workers; JobSystem::wait only helps with its own counter,
+        // so the mesh wait in World::update never picks these jobs up on the main thread
+        glm::vec3 chunkPos = glm::vec3(chunkLoc.first, 0, chunkLoc.second);
+        m_JobSystem.submit([this, chunkPos]() {
+            m_CompletedChunks.push(m_ChunkGenerator.generateChunkData(chunkPos));
+            m_ReadyChunks.fetch_add(1, std::memory_order_relaxed);
+        }, &m_GenerationJobs);
+    }
+}
+
+float ChunkLoaderSystem::requestPriority(const std::pair<int, int>& chunkLoc, const std::pair<int, int>& playerChunk,
+                                         const glm::vec2& viewDir)
+{
+    glm::vec2 offset(static_cast<float>(chunkLoc.first - playerChunk.first) / CHUNK_WIDTH,
+                     static_cast<float>(chunkLoc.second - playerChunk.second) / CHUNK_WIDTH);
+    float dist = glm::length(offset);
+    if (dist < 1.5f) // the player's chunk and its ring are needed whichever way they look
+        return dist;
+
+    // chunks straight ahead keep their distance, chunks behind count as up to three times further away
+    float facing = glm::dot(offset / dist, viewDir);
+    return dist * (2.0f - facing);
+}
+
+glm::vec2 ChunkLoaderSystem::horizontalViewDir(const glm::vec3& cameraFront)
+{
+    glm::vec2 viewDir(cameraFront.x, cameraFront.z);
+    float len = glm::length(viewDir);
+    // looking straight up/down gives no preferred direction, distance alone decides
+    return (len > 0.001f) ? viewDir / len : glm::vec2(0.0f);
+}
+
+// creates entity and attaches components, moving in the generated chunk data
+entt::entity ChunkLoaderSystem::commitChunk(ChunkPayload&& payload)
+{
+    const glm::vec3 chunkPos = payload.chunkPos;
+    const entt::entity e_Chunk = m_Registry.create();
+    m_Registry.emplace<PositionComponent>(e_Chunk, chunkPos);
+
+    // vertices are built once the chunk and its neighbours are LIT
+    // VBOs are created by RenderSystem on first upload (0 = not yet created)
+    m_Registry.emplace<MeshComponent>(e_Chunk);
+
+    m_Registry.emplace<ChunkComponent>(e_Chunk, std::move(payload.chunk));
+    m_ChunkMap.insertChunk(e_Chunk, std::make_pair(chunkPos.x, chunkPos.z));
+    m_LightEngine.stitchChunk(e_Chunk); // chunk was lit in isolation, exchange light with loaded neighbours
+
+    return e_Chunk;
 }
 
 void ChunkLoaderSystem::destroyChunk(const entt::entity& e_Chunk, glm::vec3 chunkPos)
@@ -77,7 +195,8 @@ void ChunkLoaderSystem::destroyChunk(const entt::entity& e_Chunk, glm::vec3 chun
 
     // TODO: save to disk to support changing environment
     MeshComponent& meshComp = m_Registry.get<MeshComponent>(e_Chunk);
-    glDeleteBuffers(1, &meshComp.blockVBO); // can't include in MeshComp destructor (entt swap&pop double destruct)
+    // can't include in MeshComp destructor (entt swap&pop double destruct), unused (0) names are ignored
+    glDeleteBuffers(CHUNK_SECTIONS, meshComp.sectionVBOs.data());
     m_Registry.destroy(e_Chunk); // delete entity from m_Registry
 }
 
@@ -88,3 +207,7 @@ ChunkMapComponent& ChunkLoaderSystem::createChunkMap(entt::registry& registry)
     return m_Registry.get<ChunkMapComponent>(e_ChunkMap);
 }
 
+int ChunkLoaderSystem::chunkDist(const std::pair<int, int>& a, const std::pair<int, int>& b)
+{
+    return std::max(std::abs(a.first - b.first), std::abs(a.second - b.second)) / CHUNK_WIDTH;
+}
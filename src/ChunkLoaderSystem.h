@@ -1,15 +1,23 @@
 #pragma once
 
+#include <atomic>
 #include <entt/entt.hpp>
+#include <memory>
+#include <unordered_set>
 #include <utility>
+#include <vector>
 #include "ChunkGenerator.h"
+#include "Components.h"
+#include "JobSystem.h"
+#include "LightEngine.h"
+#include "MPSCQueue.h"
 
 class ChunkMeshingSystem;
 
 class ChunkLoaderSystem {
 public:
     // eventually might need to accept path to world disk storage
-    ChunkLoaderSystem(entt::registry& registry, const int seed);
+    ChunkLoaderSystem(entt::registry& registry, const int seed, JobSystem& jobSystem, LightEngine& lightEngine);
     ~ChunkLoaderSystem();
 
     void update(entt::registry& registry);
@@ -17,15 +25,51 @@ public:
 
 private:
     entt::registry& m_Registry;
+    JobSystem& m_JobSystem;
+    LightEngine& m_LightEngine;
     ChunkMapComponent& m_ChunkMap;
     ChunkGenerator m_ChunkGenerator;
 
+    // chunks generated on worker threads wait here until the main thread commits them to the registry
+    MPSCQueue<std::unique_ptr<ChunkPayload>> m_CompletedChunks;
+    std::unordered_set<uint64_t> m_PendingChunks; // packed positions of chunks requested but not yet committed
+    JobCounter m_GenerationJobs; // outstanding generation jobs, drained on shutdown
+    std::atomic<int> m_ReadyChunks {0}; // payloads waiting in m_CompletedChunks
+
+    // requested chunks wait in a min-heap (lowest priority value first) until a worker slot frees up
+    // only a few jobs are handed to the JobSystem at once, so re-prioritising/cancelling the heap stays effective
+    struct ChunkRequest {
+        float priority;
+        std::pair<int, int> chunkLoc;
+        bool operator<(const ChunkRequest& other) const { return priority > other.priority; }
+    };
+    std::vector<ChunkRequest> m_ChunkRequests;
+    glm::vec2 m_RequestViewDir = glm::vec2(0.0f); // horizontal view direction the heap was last ordered for
+
     // refactor + expand: loadChunk (generate vs. disk), unloadChunk
+    void commitGeneratedChunks(FrameBudgetComponent& budget);
+    void updateLoadedWindow(const std::pair<int, int>& playerChunk);
+    void requestChunk(const std::pair<int, int>& chunkLoc);
+    void refreshChunkRequests(const std::pair<int, int>& playerChunk, const glm::vec2& viewDir);
+    void dispatchChunkRequests();
+    static float requestPriority(const std::pair<int, int>& chunkLoc, const std::pair<int, int>& playerChunk,
+                                 const glm::vec2& viewDir);
+    static glm::vec2 horizontalViewDir(const glm::vec3& cameraFront);
+    entt::entity commitChunk(ChunkPayload&& payload);
     void destroyChunk(const entt::entity& e_Chunk, glm::vec3 chunkPos);
     ChunkMapComponent& createChunkMap(entt::registry& registry);
 
+    // chebyshev distance (in chunks) between two chunk positions
+    static int chunkDist(const std::pair<int, int>& a, const std::pair<int, int>& b);
+
     // load all chunks that are <= $chunkLoadDistance chunks from player
-    const int chunkLoadDistance = 10;
+    static const int chunkLoadDistance = 10;
     // any chunks more than $chunkUnloadDistance from player should be removed from memory
-    const int chunkUnloadDistance = 12;
+    static const int chunkUnloadDistance = 12;
+    // loaded chunks span at most 2*chunkUnloadDistance-1 chunks per axis, which must fit in the grid
+    static_assert(2 * chunkUnloadDistance - 1 <= ChunkGrid::SIZE);
+
+    // player chunk the currently loaded window was built around
+    std::pair<int, int> m_LastPlayerChunk;
+    bool m_HasLoadedWindow = false;
 };
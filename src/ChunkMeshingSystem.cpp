@@ -1,10 +1,27 @@
 
 #include "ChunkMeshingSystem.h"
+#include <algorithm>
+#include <bit>
 #include <iostream>
+#include "BlockPool.h"
 #include "ChunkGenerator.h"
-#include <thread>
+#include "ChunkSnapshot.h"
+#include "FrameBudget.h"
 
-ChunkMeshingSystem::ChunkMeshingSystem()
+namespace {
+    // part (within a section) holding the faces on plane (0 to section size) along dim
+    int meshPartOf(int dim, int plane)
+    {
+        if (dim == 0 && (plane == 0 || plane == CHUNK_WIDTH))
+            return (plane == 0) ? WEST : EAST;
+        if (dim == 2 && (plane == 0 || plane == CHUNK_WIDTH))
+            return (plane == 0) ? SOUTH : NORTH;
+        return INTERIOR_MESH_PART;
+    }
+}
+
+ChunkMeshingSystem::ChunkMeshingSystem(JobSystem& jobSystem)
+    : m_JobSystem(jobSystem)
 {}
 
 ChunkMeshingSystem::~ChunkMeshingSystem()
@@ -12,321 +29,479 @@ ChunkMeshingSystem::~ChunkMeshingSystem()
 
 void ChunkMeshingSystem::update(entt::registry& registry)
 {
-    // view all chunks (data stored in BlockComponents)
-    std::vector<std::thread> meshUpdateThreads;
-    auto chunkView = registry.view<ChunkComponent>();
+    FrameBudgetComponent& budget = getFrameBudget(registry);
+    BudgetTimer meshTimer(budget.meshBudgetMs);
+
+    // LIT chunks need a (new) mesh once their neighbours' light is final
+    // light itself is kept current by LightEngine, edits and light changes mark the sections they touch dirty
+    // and only those are rebuilt; a never meshed chunk has every section dirty
+    // meshed chunks whose neighbour loaded or unloaded since only rebuild the border parts facing it
+    std::vector<std::pair<entt::entity, uint64_t>> meshable; // chunk, mesh parts to rebuild
+    auto chunkView = registry.view<ChunkComponent, MeshComponent>();
     for (const auto& e_Chunk : chunkView)
     {
-//        // if newly loaded chunk not yet initialized, doesn't require mesh update for next frame
-//        MeshComponent& meshComp = registry.get<MeshComponent>(e_Chunk);
-//        if (not meshComp.initialized && not meshComp.startedInit) {
-//            meshComp.startedInit = true;
-//            std::thread initMeshThread(&ChunkMeshingSystem::initNewChunk, this, e_Chunk, std::ref(registry));
-//            initMeshThread.detach();
-//            continue;
-//        }
-
-        // only have to update mesh for next frame if blocks have changed
-        if (chunkView.get<ChunkComponent>(e_Chunk).hasChanged()) {
-            meshUpdateThreads.emplace_back([&registry, &e_Chunk, this]() {
-                ChunkGenerator::updateLightMap(registry.get<ChunkComponent>(e_Chunk));
-                greedyMesh(e_Chunk, registry); // strategy? swap for debug
-                // constructMesh(chunk, registry);
-            });
+        const ChunkComponent& chunkComp = chunkView.get<ChunkComponent>(e_Chunk);
+        uint64_t staleParts = chunkView.get<MeshComponent>(e_Chunk).staleParts;
+        if (chunkComp.status() == ChunkStatus::LIT && neighborsReached(registry, chunkComp, ChunkStatus::LIT))
+            meshable.emplace_back(e_Chunk, sectionMeshParts(chunkComp.dirtySections()) | staleParts);
+        else if (chunkComp.hasReached(ChunkStatus::MESHED) && staleParts != 0)
+            meshable.emplace_back(e_Chunk, staleParts);
+    }
+
+    // mesh in rounds of one chunk per thread while another round still fits into the budget
+    // chunks left over keep their status and are picked up next frame
+    const size_t roundSize = m_JobSystem.workerCount() + 1;
+    size_t meshed = 0;
+    double lastRoundMs = 0.0;
+    while (meshed < meshable.size()
+           && (meshed == 0 || meshTimer.elapsedMs() + lastRoundMs < budget.meshBudgetMs))
+    {
+        double roundStartMs = meshTimer.elapsedMs();
+        // snapshots are taken here on the main thread, jobs only read their snapshot and fill their own job
+        size_t roundEnd = std::min(meshable.size(), meshed + roundSize);
+        std::vector<MeshJob> jobs;
+        jobs.reserve(roundEnd - meshed);
+        for (; meshed < roundEnd; meshed++)
+        {
+            auto [e_Chunk, parts] = meshable[meshed];
+            jobs.push_back({e_Chunk, parts, ChunkSnapshot(registry, e_Chunk, meshPartSections(parts)), {}});
         }
+
+        JobCounter meshUpdateJobs;
+        MeshingMethod method = m_MeshingMethod;
+        for (MeshJob& job : jobs)
+            m_JobSystem.submit([&job, method, this]() {
+                buildMesh(job.snapshot, method, job.parts, job.partVertices);
+            }, &meshUpdateJobs);
+        m_JobSystem.wait(meshUpdateJobs);
+
+        for (const MeshJob& job : jobs)
+            applyMesh(registry, job.chunk, job.parts, job.partVertices);
+        lastRoundMs = meshTimer.elapsedMs() - roundStartMs;
     }
-    for (std::thread& t : meshUpdateThreads)
-        t.join();
+    budget.chunksMeshed = static_cast<int>(meshed);
+    budget.meshesDeferred = static_cast<int>(meshable.size() - meshed);
 }
 
-void ChunkMeshingSystem::initNewChunk(const entt::entity& e_Chunk, entt::registry& registry)
+bool ChunkMeshingSystem::neighborsReached(entt::registry& registry, const ChunkComponent& chunkComp,
+                                          ChunkStatus stage)
 {
-    ChunkComponent& chunkComp = registry.get<ChunkComponent>(e_Chunk);
-//    ChunkGenerator::updateLightMap(chunkComp); // must be done before meshing
-    greedyMesh(e_Chunk, registry);
-    registry.get<MeshComponent>(e_Chunk).initialized = true; // note mesh has been initialized
+    // chunks on the edge of the loaded area wait until the player comes close enough to load their neighbour
+    for (int dir = NORTH; dir <= EAST; dir++)
+    {
+        entt::entity e_Neighbor = chunkComp.neighborEntities[dir];
+        if (e_Neighbor == entt::null || not registry.get<ChunkComponent>(e_Neighbor).hasReached(stage))
+            return false;
+    }
+    return true;
 }
 
-void ChunkMeshingSystem::constructMesh(entt::entity chunk, entt::registry& registry)
+void ChunkMeshingSystem::meshChunk(entt::entity chunk, entt::registry& registry, MeshingMethod method,
+                                   uint64_t parts)
 {
-    // retrieve refs to block data & vertex storage
-    ChunkComponent& blocks = registry.get<ChunkComponent>(chunk);
-    std::vector<texArrayVertex>& vertices = registry.get<MeshComponent>(chunk).chunkVertices;
-    glm::vec3& pos = registry.get<PositionComponent>(chunk).pos;
-
-    vertices.clear(); // delete old vertex data
+    PartVertices partVertices;
+    buildMesh(ChunkSnapshot(registry, chunk, meshPartSections(parts)), method, parts, partVertices);
+    applyMesh(registry, chunk, parts, partVertices);
+}
 
-    // aligns direction with faces 0-5 in loop
-    // WEST, DOWN, NORTH, EAST, UP, SOUTH
-    Direction dir[] = {
-            WEST, DOWN, NORTH, EAST, UP, SOUTH
-    };
+void ChunkMeshingSystem::buildMesh(const ChunkSnapshot& snapshot, MeshingMethod method, uint64_t parts,
+                                   PartVertices& partVertices) const
+{
+    if (method == MeshingMethod::BINARY_GREEDY)
+        binaryGreedyMesh(snapshot, parts, partVertices);
+    else
+        greedyMesh(snapshot, parts, partVertices);
+}
 
-    // create new vertex data for mesh from scratch
-    // position.pos refers to (i, j, k) = (0, 0, 0) in world coordinates
-    // i, j, k refer to block position in chunk coordinates
-    for (int k = 0; k < CHUNK_WIDTH; k++)
-        for (int j = 0; j < CHUNK_HEIGHT; j++)
-            for (int i = 0; i < CHUNK_WIDTH; i++)
-                for (int face = 0; face < 6; face++) // 6 faces for each cube
-                    for (int v = 0; v < 6; v++)
-                    { // 6 vertices for each face
-                        if (blocks.blockAt(i, j, k)->typeOf() == AIR)
-                            continue;
-                        int dim = face % 3;
-                        // follows UV coordinates of texture across 2D face surface
-                        // also aligns UV with position in world space
-                        float xVertOffset, yVertOffset, zVertOffset;
-                        if (dim == 0) {
-                            xVertOffset = 0.0f;
-                            yVertOffset = uvCoords[2*v + 1];
-                            zVertOffset = uvCoords[2*v];
-                        } else if (dim == 1) {
-                            xVertOffset = uvCoords[2*v];
-                            yVertOffset = 0.0f;
-                            zVertOffset = uvCoords[2*v + 1];
-                        } else { // dim == 2
-                            xVertOffset = uvCoords[2*v];
-                            yVertOffset = uvCoords[2*v + 1];
-                            zVertOffset = 0.0f;
-                        }
-                        // offsets by 1 in x, y, and z direction to create parallel faces
-                        float xFaceOffset = (face == 3) ? 1.0f : 0.0f;
-                        float yFaceOffset = (face == 4) ? 1.0f : 0.0f;
-                        float zFaceOffset = (face == 5) ? 1.0f : 0.0f;
-                        // need to support different textures by side
-                        // current dim scheme (face = 0 through 5)
-                        // WEST, DOWN, NORTH, EAST, UP, SOUTH
-                        vertices.emplace_back(
-                                //                         mesh corner + block corner + UV + 0/1
-                                static_cast<GLfloat>(pos.x + i + xVertOffset + xFaceOffset),
-                                static_cast<GLfloat>(pos.y + j + yVertOffset + yFaceOffset),
-                                static_cast<GLfloat>(pos.z + k + zVertOffset + zFaceOffset),
-                                uvCoords[v*2], uvCoords[v*2 + 1],
-                                static_cast<GLfloat>(blocks.blockAt(i, j, k)->sideAtDir(dir[face])),
-                                0xFF
-                        );
-                    }
+void ChunkMeshingSystem::applyMesh(entt::registry& registry, entt::entity chunk, uint64_t parts,
+                                   const PartVertices& partVertices)
+{
+    MeshComponent& meshComp = registry.get<MeshComponent>(chunk);
+    ChunkComponent& chunkComp = registry.get<ChunkComponent>(chunk);
+    for (int part = 0; part < MESH_PARTS; part++)
+        if (parts & (uint64_t{1} << part))
+            meshComp.replacePart(part, partVertices[part]);
+    meshComp.staleParts &= ~parts;
+
+    // sections rebuilt whole are up to date, any rebuilt part needs its section re-uploaded
+    for (int sectionIdx = 0; sectionIdx < CHUNK_SECTIONS; sectionIdx++)
+    {
+        uint64_t sectionParts = sectionMeshParts(1 << sectionIdx);
+        if ((parts & sectionParts) == sectionParts)
+            chunkComp.clearDirtySections(1 << sectionIdx);
+    }
+    meshComp.unuploadedSections |= meshPartSections(parts);
 
-    // note that new mesh was constructed based on changes
-    // pretty sure this is an lvalue so this works
-    registry.get<ChunkComponent>(chunk).markChangesResolved();
-    registry.get<MeshComponent>(chunk).mustUpdateBuffer = true;
+    // note that new mesh was constructed, RenderSystem uploads it
+    chunkComp.setStatus(ChunkStatus::MESHED);
 }
 
-void ChunkMeshingSystem::greedyMesh(entt::entity chunk, entt::registry& registry)
+void ChunkMeshingSystem::greedyMesh(const ChunkSnapshot& snapshot, uint64_t parts, PartVertices& partVertices) const
 {
-    // retrieve refs to block data & vertex storage
-    ChunkComponent& blocks = registry.get<ChunkComponent>(chunk);
-    std::vector<texArrayVertex>& vertices = registry.get<MeshComponent>(chunk).chunkVertices;
-    glm::vec3& pos = registry.get<PositionComponent>(chunk).pos;
-
-    vertices.clear(); // delete old vertex data
+    const BlockPool& blockPool = BlockPool::getPoolInstance();
 
     Direction bFaceDirs[3] = {EAST, UP, NORTH}; // x, y, z indexing to support dim, u, v indexing
     Direction fFaceDirs[3] = {WEST, DOWN, SOUTH};
-    // x, y, z indexing to support dim, u, v indexing: gives max index in chunk array
-    int chunkDimSize[3] = {CHUNK_WIDTH, CHUNK_HEIGHT, CHUNK_WIDTH};
+    // x, y, z indexing to support dim, u, v indexing: gives max index in section
+    int chunkDimSize[3] = {CHUNK_WIDTH, SECTION_HEIGHT, CHUNK_WIDTH};
+
+    // air-ness of a whole y layer when it lies in a uniform section (outside the chunk counts as air)
+    const int UNKNOWN_AIRNESS = -1;
+    auto layerAirness = [&](int y) -> int {
+        if (y < 0 || y >= CHUNK_HEIGHT)
+            return 1;
+        return snapshot.isSectionUniform(y / SECTION_HEIGHT) ? (snapshot.typeAt(0, y, 0) == AIR) : UNKNOWN_AIRNESS;
+    };
 
     // ---------------------- GREEDY MESHING ALGORITHM ----------------------
 
-    // sweep over each dimension (constructs both faces per dim)
-    // dim = dimension perpendicular to mask face
-    for (int dim = 0; dim < 3; dim++)
+    // every section is meshed on its own, voxel coordinates below are section-local
+    for (int sectionIdx = 0; sectionIdx < CHUNK_SECTIONS; sectionIdx++)
     {
-        Direction bDir = bFaceDirs[dim];
-        Direction fDir = fFaceDirs[dim];
-        // track dimensions of blockMask plane
-        int u = (dim + 1) % 3;
-        int v = (dim + 2) % 3;
-        // dVec = unit vector perpendicular to blockMask
-        int dVec[3] = {0, 0, 0};
-        dVec[dim] = 1;
-        // tracks position (relative to local voxel coordinates where start = (0,0,0) & max=(CHUNK_WIDTH-1, ...)
-        std::vector<int> curVox(3, 0);
-
-        // dirs[dim][bFace == AIR] gives direction of face from voxel
-        std::vector<std::vector<Direction>> dirs {{WEST, EAST}, {DOWN, UP}, {SOUTH, NORTH}};
-
-        // tracks face type in UV plane that dim passes through
-        BlockType blockMask[chunkDimSize[u] * chunkDimSize[v]]; // must explicitly define each entry, AIR!=default
-
-        for (curVox[dim] = -1; curVox[dim] < chunkDimSize[dim]; ) // depth=N has N+1 faces
+        uint8_t sectionParts = (parts >> (sectionIdx * PARTS_PER_SECTION)) & ((1 << PARTS_PER_SECTION) - 1);
+        if (sectionParts == 0)
+            continue;
+        int sectionY = sectionIdx * SECTION_HEIGHT;
+        glm::ivec3 sectionOffset(0, sectionY, 0);
+        // uniform (all-air or single type) sections let whole runs of the sweep skip per-voxel lookups
+        bool sectionUniform = snapshot.isSectionUniform(sectionIdx);
+
+        // sweep over each dimension (constructs both faces per dim)
+        // dim = dimension perpendicular to mask face
+        for (int dim = 0; dim < 3; dim++)
         {
-            std::vector<uint8_t> lightMask(chunkDimSize[u] * chunkDimSize[v], 0);
-            std::vector<int> dirMask(chunkDimSize[u] * chunkDimSize[v], -1); // for invalid enum default value
+            Direction bDir = bFaceDirs[dim];
+            Direction fDir = fFaceDirs[dim];
+            // track dimensions of blockMask plane
+            int u = (dim + 1) % 3;
+            int v = (dim + 2) % 3;
+            // dVec = unit vector perpendicular to blockMask
+            int dVec[3] = {0, 0, 0};
+            dVec[dim] = 1;
+            // tracks position (relative to local voxel coordinates where start = (0,0,0) & max=(CHUNK_WIDTH-1, ...)
+            std::vector<int> curVox(3, 0);
+
+            // tracks face type in UV plane that dim passes through
+            BlockType blockMask[chunkDimSize[u] * chunkDimSize[v]]; // must explicitly define each entry, AIR!=default
+
+            for (curVox[dim] = -1; curVox[dim] < chunkDimSize[dim]; ) // depth=N has N+1 faces
+            {
+                std::vector<uint8_t> lightMask(chunkDimSize[u] * chunkDimSize[v], 0);
+                std::vector<int> dirMask(chunkDimSize[u] * chunkDimSize[v], -1); // for invalid enum default value
 
-            // ---------------------- COMPUTE MASK ----------------------
-            for (curVox[v] = 0; curVox[v] < chunkDimSize[v]; curVox[v]++)
-                for (curVox[u] = 0; curVox[u] < chunkDimSize[u]; curVox[u]++)
+                // ---------------------- COMPUTE MASK ----------------------
+                // only the planes of the requested parts are rebuilt, the underside of the world is never seen
+                int part = meshPartOf(dim, curVox[dim] + 1);
+                if (not (sectionParts & (1 << part)) || (dim == 1 && curVox[1] < 0 && sectionIdx == 0))
                 {
-                    // voxels behind + in front of face of interest
-                    BlockType bFace = (curVox[dim] >= 0) ?
-                                      blocks.blockAt(curVox[0], curVox[1], curVox[2])->sideAtDir(bDir) : AIR;
-                    BlockType fFace = (curVox[dim] < chunkDimSize[dim] - 1) ?
-                                      blocks.blockAt(curVox[0] + dVec[0],
-                                                     curVox[1] + dVec[1],
-                                                     curVox[2] + dVec[2])->sideAtDir(fDir) : AIR;
-
-                    // only draw face if EXACTLY one side is AIR
-                    blockMask[curVox[u] + curVox[v] * chunkDimSize[u]] = ((bFace == AIR) != (fFace == AIR)) ?
-                                                                                ((bFace != AIR) ? bFace : fFace) : AIR;
-                    // identify direction of face from non-AIR block
-                    dirMask[curVox[u] + curVox[v] * chunkDimSize[u]] = dirs[dim][(bFace == AIR)];
-
-                    // track light level of drawn face (light at AIR block)
-                    // must supply x, y, z coordinates of non-AIR block
-                    int x, y, z;
-                    if (bFace == AIR) // get light level adjacent AIR block
-                        lightMask[curVox[u] + curVox[v] * chunkDimSize[u]]
-                                = getLightLevelAt(registry, chunk, blocks, curVox[0], curVox[1], curVox[2]);
-                    else // fFace, one step in dVec (across face), is AIR
-                        lightMask[curVox[u] + curVox[v] * chunkDimSize[u]]
-                                = getLightLevelAt(registry, chunk, blocks, curVox[0] + dVec[0],
-                                                  curVox[1] + dVec[1], curVox[2] + dVec[2]);
+                    curVox[dim]++;
+                    continue;
                 }
+                // planes between two uniform layers of equal air-ness (e.g. inside solid stone or open sky)
+                // have no faces
+                bool onSectionBorder = curVox[dim] < 0 || curVox[dim] >= chunkDimSize[dim] - 1;
+                if (dim == 1 && layerAirness(sectionY + curVox[1]) != UNKNOWN_AIRNESS
+                             && layerAirness(sectionY + curVox[1]) == layerAirness(sectionY + curVox[1] + 1))
+                {
+                    curVox[dim]++;
+                    continue;
+                }
+
+                for (curVox[v] = 0; curVox[v] < chunkDimSize[v]; curVox[v]++)
+                    for (curVox[u] = 0; curVox[u] < chunkDimSize[u]; curVox[u]++)
+                    {
+                        // inside a uniform section both voxels share the same type, no face to draw
+                        if (dim != 1 && not onSectionBorder && sectionUniform) {
+                            blockMask[curVox[u] + curVox[v] * chunkDimSize[u]] = AIR;
+                            continue;
+                        }
+
+                        // voxels behind + in front of face of interest, the snapshot's border holds the neighbours'
+                        BlockType bFace = blockPool.getBlockPtr(snapshot.typeAt(curVox[0], sectionY + curVox[1],
+                                                                                curVox[2]))->sideAtDir(bDir);
+                        BlockType fFace = blockPool.getBlockPtr(snapshot.typeAt(curVox[0] + dVec[0],
+                                                                                sectionY + curVox[1] + dVec[1],
+                                                                                curVox[2] + dVec[2]))->sideAtDir(fDir);
+                        // faces of the neighbour's (or the section above/below's) blocks belong to their mesh
+                        bool outsideFace = (curVox[dim] < 0) ? bFace != AIR
+                                                             : (curVox[dim] == chunkDimSize[dim] - 1 && fFace != AIR);
+
+                        // only draw face if EXACTLY one side is AIR
+                        blockMask[curVox[u] + curVox[v] * chunkDimSize[u]]
+                                = ((bFace == AIR) != (fFace == AIR)) && not outsideFace ?
+                                        ((bFace != AIR) ? bFace : fFace) : AIR;
+                        if (blockMask[curVox[u] + curVox[v] * chunkDimSize[u]] == AIR)
+                            continue; // light only matters for drawn faces
+                        // direction the face points in, away from its non-AIR block
+                        dirMask[curVox[u] + curVox[v] * chunkDimSize[u]] = (bFace != AIR) ? bDir : fDir;
+
+                        // track light level of drawn face (light at AIR block)
+                        // must supply x, y, z coordinates of non-AIR block
+                        if (bFace == AIR) // get light level adjacent AIR block
+                            lightMask[curVox[u] + curVox[v] * chunkDimSize[u]]
+                                    = snapshot.lightAt(curVox[0], sectionY + curVox[1], curVox[2]);
+                        else // fFace, one step in dVec (across face), is AIR
+                            lightMask[curVox[u] + curVox[v] * chunkDimSize[u]]
+                                    = snapshot.lightAt(curVox[0] + dVec[0], sectionY + curVox[1] + dVec[1],
+                                                       curVox[2] + dVec[2]);
+                    }
 
-            // starts at -1 for first face, which is truly blockAt 0 relative to chunk --> inc reflects face position
-            curVox[dim]++;
+                // starts at -1 for first face, which is truly blockAt 0 relative to section
+                // --> inc reflects face position
+                curVox[dim]++;
 
-            // ---------------------- GENERATE MESH FOR MASK ----------------------
-            // iterate across blockMask, grouping together equal adjacent faces
-            for (int j = 0; j < chunkDimSize[v]; j++)
-            {
-                for (int i = 0; i < chunkDimSize[u];)
+                // ---------------------- GENERATE MESH FOR MASK ----------------------
+                // iterate across blockMask, grouping together equal adjacent faces
+                for (int j = 0; j < chunkDimSize[v]; j++)
                 {
-                    BlockType curFace = blockMask[i + j * chunkDimSize[u]];
-                    uint8_t curLightLevel = lightMask[i + j * chunkDimSize[u]];
-                    if (curFace == AIR) {
-                        i++;
-                        continue; // ignore blank faces
+                    for (int i = 0; i < chunkDimSize[u];)
+                    {
+                        BlockType curFace = blockMask[i + j * chunkDimSize[u]];
+                        uint8_t curLightLevel = lightMask[i + j * chunkDimSize[u]];
+                        int curDir = dirMask[i + j * chunkDimSize[u]];
+                        if (curFace == AIR) {
+                            i++;
+                            continue; // ignore blank faces
+                        }
+                        auto sameFace = [&](int maskIdx) {
+                            return blockMask[maskIdx] == curFace && lightMask[maskIdx] == curLightLevel
+                                   && dirMask[maskIdx] == curDir;
+                        };
+
+                        // find maximum width of identically drawn faces (block face, light level, direction)
+                        int width = 1; // absolute length
+                        while (i + width < chunkDimSize[u] && sameFace(i + width + j * chunkDimSize[u]))
+                        {
+                            width++;
+                        }
+                        // find maximum height (given width) of identically drawn faces
+                        int height = 1; // absolute length
+                        while (j + height < chunkDimSize[v])
+                        {
+                            // move across width-direction, checking all faces are identical (face type, light, dir)
+                            int wIncrement = 0;
+                            while (wIncrement < width && sameFace(i + wIncrement + (j + height) * chunkDimSize[u]))
+                            { wIncrement++; }
+                            if (wIncrement == width) // entire height column matches curFace, can append entire column
+                                height++;
+                            else // can only increment height if full width-length column is of same texture
+                                break;
+                        }
+
+                        // store quad vertices for rendering (ultimately 2 triangles)
+                        curVox[u] = i; // curVox[dim] already accurate, [u] and [v] reset on next blockMask creation
+                        curVox[v] = j;
+                        // dU and dV are vectors in u/v directions of width/height lengths, curVox+dU+dV = end of quad
+                        int dU[3] = {0, 0, 0};
+                        dU[u] = width;
+                        int dV[3] = {0, 0, 0};
+                        dV[v] = height;
+
+                        glm::ivec3 vStart, vU, vV, vEnd; // vU stretches in u/width dir, vV stretches in v/height dir
+                        // section-local corners, the section's offset is added below, the chunk's position when drawing
+                        vStart[0] = curVox[0]; vStart[1] = curVox[1]; vStart[2] = curVox[2];
+                        // vU = curVox corner offset by width (curVox + dU)
+                        vU[0] = curVox[0] + dU[0]; vU[1] = curVox[1] + dU[1]; vU[2] = curVox[2] + dU[2];
+                        // vV = curVox corner offset by height (curVox + dV)
+                        vV[0] = curVox[0] + dV[0]; vV[1] = curVox[1] + dV[1]; vV[2] = curVox[2] + dV[2];
+                        // vEnd = opposite curVox start corner (curVox + dU + dV)
+                        vEnd[0] = curVox[0] + dU[0] + dV[0]; vEnd[1] = curVox[1] + dU[1] + dV[1];
+                        vEnd[2] = curVox[2] + dU[2] + dV[2];
+
+                        appendQuad(vStart + sectionOffset, vU + sectionOffset, vV + sectionOffset, vEnd + sectionOffset,
+                                   curFace, width, height, static_cast<Direction>(curDir),
+                                   partVertices[sectionIdx * PARTS_PER_SECTION + part], curLightLevel);
+
+                        // clear masks for subsequent passes (prevents drawing same face again)
+                        for (int h = 0; h < height; h++)
+                            for (int w = 0; w < width; w++)
+                                blockMask[i + w + (j + h) * chunkDimSize[u]] = AIR,
+                                lightMask[i + w + (j + h) * chunkDimSize[u]] = 0,
+                                dirMask[i + w + (j + h) * chunkDimSize[u]] = -1;
+
+                        i += width;
                     }
+                }
+            }
+        }
+    }
+}
+
+void ChunkMeshingSystem::binaryGreedyMesh(const ChunkSnapshot& snapshot, uint64_t parts,
+                                          PartVertices& partVertices) const
+{
+    const BlockPool& blockPool = BlockPool::getPoolInstance();
 
-                    // find maximum width of identically drawn faces (block face and light level)
-                    int width = 1; // absolute length
-                    while (i + width < chunkDimSize[u] && blockMask[i + width + j * chunkDimSize[u]] == curFace
-                                                       && lightMask[i + width + j * chunkDimSize[u]] == curLightLevel)
+    Direction bFaceDirs[3] = {EAST, UP, NORTH}; // x, y, z indexing to support dim, u, v indexing
+    Direction fFaceDirs[3] = {WEST, DOWN, SOUTH};
+    int sectionDimSize[3] = {CHUNK_WIDTH, SECTION_HEIGHT, CHUNK_WIDTH};
+    // parts each dim's planes can fall into
+    uint8_t dimParts[3] = {(1 << WEST) | (1 << EAST) | (1 << INTERIOR_MESH_PART), 1 << INTERIOR_MESH_PART,
+                           (1 << SOUTH) | (1 << NORTH) | (1 << INTERIOR_MESH_PART)};
+
+    // faces of the plane at depth d along dim: faceRows[d * sectionDimSize[v] + v] has bit u set,
+    // faceKeys[(d * sectionDimSize[v] + v) * sectionDimSize[u] + u] holds its face type << 9 | backFace << 8 | light
+    // (a plane cell holds either a back or a front face, never both, but quads only merge faces of one direction)
+    std::vector<uint32_t> faceRows;
+    std::vector<uint32_t> faceKeys;
+
+    // every section is meshed on its own, voxel coordinates below are section-local
+    for (int sectionIdx = 0; sectionIdx < CHUNK_SECTIONS; sectionIdx++)
+    {
+        uint8_t sectionParts = (parts >> (sectionIdx * PARTS_PER_SECTION)) & ((1 << PARTS_PER_SECTION) - 1);
+        int sectionY = sectionIdx * SECTION_HEIGHT;
+        glm::ivec3 sectionOffset(0, sectionY, 0);
+
+        for (int dim = 0; dim < 3; dim++)
+        {
+            if (not (sectionParts & dimParts[dim]))
+                continue;
+            int u = (dim + 1) % 3;
+            int v = (dim + 2) % 3;
+            int planes = sectionDimSize[dim] + 1; // depth=N has N+1 faces
+            faceRows.assign(planes * sectionDimSize[v], 0);
+            faceKeys.resize(planes * sectionDimSize[v] * sectionDimSize[u]);
+
+            // ---------------------- FIND FACES ----------------------
+            // a face is drawn where exactly one side is AIR: solid voxels whose neighbour along dim is not solid
+            // back faces lie on the voxel's + side (AIR at +1), front faces on its - side (AIR at -1)
+            // only this section's voxels are scanned, faces of other sections' and the neighbours' blocks belong
+            // to their meshes
+            auto addFaces = [&](uint16_t faces, int y, int z, bool backFace) {
+                for (; faces != 0; faces &= faces - 1)
+                {
+                    int voxel[3] = {std::countr_zero(faces), y, z};
+                    int plane = voxel[dim] + (backFace ? 1 : 0);
+                    if (not (sectionParts & (1 << meshPartOf(dim, plane))))
+                        continue;
+                    int air[3] = {voxel[0], voxel[1], voxel[2]};
+                    air[dim] += backFace ? 1 : -1;
+
+                    BlockType face = blockPool.getBlockPtr(snapshot.typeAt(voxel[0], sectionY + voxel[1], voxel[2]))
+                            ->sideAtDir(backFace ? bFaceDirs[dim] : fFaceDirs[dim]);
+                    uint8_t lightLevel = snapshot.lightAt(air[0], sectionY + air[1], air[2]);
+                    int row = plane * sectionDimSize[v] + voxel[v];
+                    faceRows[row] |= 1u << voxel[u];
+                    faceKeys[row * sectionDimSize[u] + voxel[u]]
+                            = (static_cast<uint32_t>(face) << 9) | (backFace ? 1u << 8 : 0u) | lightLevel;
+                }
+            };
+            // a border-only rebuild scans just the voxels next to the border
+            bool interior = sectionParts & (1 << INTERIOR_MESH_PART);
+            uint16_t rowVoxels = (dim != 0 || interior) ? 0xFFFF : ((sectionParts & (1 << WEST)) ? 1 : 0)
+                                                                   | ((sectionParts & (1 << EAST)) ? 0x8000 : 0);
+            for (int y = 0; y < SECTION_HEIGHT; y++)
+                for (int z = 0; z < CHUNK_WIDTH; z++)
+                {
+                    if (dim == 2 && not interior && z != 0 && z != CHUNK_WIDTH - 1)
+                        continue;
+                    int chunkY = sectionY + y;
+                    uint32_t row = snapshot.solidRow(chunkY, z);
+                    if ((row & 0x1FFFE) == 0)
+                        continue;
+                    // solid neighbours along dim in the snapshot's padded bits: x shifts within the row, y and z
+                    // are neighbouring rows (the border ones from the neighbours); below y = 0 counts as solid,
+                    // the world's underside is never seen
+                    uint32_t above, below;
+                    if (dim == 0)
                     {
-                        width++;
+                        above = row >> 1;
+                        below = row << 1;
                     }
-                    // find maximum height (given width) of identically drawn faces
-                    int height = 1; // absolute length
-                    while (j + height < chunkDimSize[v])
+                    else if (dim == 1)
                     {
-                        // move across width-direction, checking all faces are identical (face type, light)
-                        int wIncrement = 0;
-                        while (wIncrement < width && blockMask[i + wIncrement + (j + height) * chunkDimSize[u]] == curFace
-                                                  && lightMask[i + wIncrement + (j + height) * chunkDimSize[u]] == curLightLevel)
-                        { wIncrement++; }
-                        if (wIncrement == width) // entire height column matches curFace, can append entire column
-                            height++;
-                        else // can only increment height if full width-length column is of same texture
-                            break;
+                        above = snapshot.solidRow(chunkY + 1, z);
+                        below = (chunkY > 0) ? snapshot.solidRow(chunkY - 1, z) : ~0u;
+                    }
+                    else
+                    {
+                        above = snapshot.solidRow(chunkY, z + 1);
+                        below = snapshot.solidRow(chunkY, z - 1);
                     }
+                    // back to this chunk's 16 columns
+                    addFaces(static_cast<uint16_t>((row & ~above) >> 1) & rowVoxels, y, z, true);
+                    addFaces(static_cast<uint16_t>((row & ~below) >> 1) & rowVoxels, y, z, false);
+                }
 
-                    // store quad vertices for rendering (ultimately 2 triangles)
-                    curVox[u] = i; // curVox[dim] already accurate, [u] and [v] reset on next blockMask creation
-                    curVox[v] = j;
-                    // dU and dV are vectors in u/v directions of width/height lengths, curVox+dU+dV = end of quad
-                    int dU[3] = {0, 0, 0};
-                    dU[u] = width;
-                    int dV[3] = {0, 0, 0};
-                    dV[v] = height;
-
-                    glm::vec3 vStart, vU, vV, vEnd; // vU stretches in u/width dir, vV stretches in v/height dir
-                    // note: must offset by chunk location (pos = vec3, absolute chunk location)
-                    // curVox (absolute location, not within-chunk location)
-                    vStart[0] = pos[0] + curVox[0]; vStart[1] = pos[1] + curVox[1]; vStart[2] = pos[2] + curVox[2];
-                    // vU = curVox corner offset by width (curVox + dU)
-                    vU[0] = pos[0] + curVox[0] + dU[0]; vU[1] = pos[1] + curVox[1] + dU[1]; vU[2] = pos[2] + curVox[2] + dU[2];
-                    // vV = curVox corner offset by height (curVox + dV)
-                    vV[0] = pos[0] + curVox[0] + dV[0]; vV[1] = pos[1] + curVox[1] + dV[1]; vV[2] = pos[2] + curVox[2] + dV[2];
-                    // vEnd = opposite curVox start corner (curVox + dU + dV)
-                    vEnd[0] = pos[0] + curVox[0] + dU[0] + dV[0]; vEnd[1] = pos[1] + curVox[1] + dU[1] + dV[1];
-                    vEnd[2] = pos[2] + curVox[2] + dU[2] + dV[2];
-
-                    appendQuad(vStart, vU, vV, vEnd, curFace, width, height, dirs[dim][0], vertices, curLightLevel);
-
-                    // clear masks for subsequent passes (prevents drawing same face again)
-                    for (int h = 0; h < height; h++)
-                        for (int w = 0; w < width; w++)
-                            blockMask[i + w + (j + h) * chunkDimSize[u]] = AIR,
-                            lightMask[i + w + (j + h) * chunkDimSize[u]] = 0,
-                            dirMask[i + w + (j + h) * chunkDimSize[u]] = -1;
-
-                    i += width;
+            // ---------------------- MERGE QUADS ----------------------
+            // same order as greedyMesh: rows of v, lowest u first, grown along u then v over equal keys
+            // planes of parts that were not requested found no faces
+            for (int d = 0; d < planes; d++)
+                for (int j = 0; j < sectionDimSize[v]; j++)
+                {
+                    uint32_t& faceRow = faceRows[d * sectionDimSize[v] + j];
+                    while (faceRow != 0)
+                    {
+                        int i = std::countr_zero(faceRow);
+                        auto keyAt = [&](int ui, int vj) {
+                            return faceKeys[(d * sectionDimSize[v] + vj) * sectionDimSize[u] + ui];
+                        };
+                        uint32_t key = keyAt(i, j);
+
+                        int width = 1;
+                        while (i + width < sectionDimSize[u] && ((faceRow >> (i + width)) & 1)
+                               && keyAt(i + width, j) == key)
+                            width++;
+                        uint32_t span = ((1u << width) - 1) << i;
+                        int height = 1;
+                        while (j + height < sectionDimSize[v])
+                        {
+                            uint32_t nextRow = faceRows[d * sectionDimSize[v] + j + height];
+                            int matching = 0;
+                            if ((nextRow & span) == span)
+                                while (matching < width && keyAt(i + matching, j + height) == key)
+                                    matching++;
+                            if (matching != width)
+                                break;
+                            height++;
+                        }
+                        for (int h = 0; h < height; h++)
+                            faceRows[d * sectionDimSize[v] + j + h] &= ~span;
+
+                        glm::ivec3 vStart;
+                        vStart[dim] = d;
+                        vStart[u] = i;
+                        vStart[v] = j;
+                        vStart += sectionOffset;
+                        glm::ivec3 dU(0), dV(0);
+                        dU[u] = width;
+                        dV[v] = height;
+                        Direction faceDir = (key & (1u << 8)) ? bFaceDirs[dim] : fFaceDirs[dim];
+                        appendQuad(vStart, vStart + dU, vStart + dV, vStart + dU + dV,
+                                   static_cast<BlockType>(key >> 9), width, height, faceDir,
+                                   partVertices[sectionIdx * PARTS_PER_SECTION + meshPartOf(dim, d)], key & 0xFF);
+                    }
                 }
-            }
         }
     }
-
-    // note that new mesh was constructed based on changes
-    // pretty sure this is an lvalue so this works
-    registry.get<ChunkComponent>(chunk).markChangesResolved();
-    registry.get<MeshComponent>(chunk).mustUpdateBuffer = true;
 }
 
-// appends a face to the texArrayVertex vector (two triangles/6 vertices, "quad" for short)
-void ChunkMeshingSystem::appendQuad(glm::vec3 vStart, glm::vec3 vWidth, glm::vec3 vHeight, glm::vec3 vEnd,
+// appends a face to the texArrayVertex vector (two triangles/4 vertices, "quad" for short)
+void ChunkMeshingSystem::appendQuad(glm::ivec3 vStart, glm::ivec3 vWidth, glm::ivec3 vHeight, glm::ivec3 vEnd,
                               BlockType block, int width, int height,
                               Direction dir, std::vector<texArrayVertex>& vertices,
-                              uint8_t lightLevel)
+                              uint8_t lightLevel) const
                               {
 
     BlockType blockSide = sideLookup(block, dir);
+    auto emitVertex = [&](const glm::ivec3& corner, float uTexCoord, float vTexCoord) {
+        vertices.emplace_back(corner.x, corner.y, corner.z, static_cast<int>(uTexCoord), static_cast<int>(vTexCoord),
+                              blockSide, dir, lightLevel);
+    };
 
+    // 4 corners, the two triangles come from the shared quad index buffer
     if (dir == WEST || dir == EAST)
     {
-        vertices.emplace_back(vStart.x, vStart.y, vStart.z, uvCoords[1]*height, uvCoords[0]*width, blockSide, lightLevel);
-        vertices.emplace_back(vWidth.x, vWidth.y, vWidth.z, uvCoords[3]*height, uvCoords[2]*width, blockSide, lightLevel);
-        vertices.emplace_back(vHeight.x, vHeight.y, vHeight.z, uvCoords[5]*height, uvCoords[4]*width, blockSide, lightLevel);
-        vertices.emplace_back(vHeight.x, vHeight.y, vHeight.z, uvCoords[7]*height, uvCoords[6]*width, blockSide, lightLevel);
-        vertices.emplace_back(vEnd.x, vEnd.y, vEnd.z, uvCoords[9]*height, uvCoords[8]*width, blockSide, lightLevel);
-        vertices.emplace_back(vWidth.x, vWidth.y, vWidth.z, uvCoords[11]*height, uvCoords[10]*width, blockSide, lightLevel);
+        emitVertex(vStart, uvCoords[1]*height, uvCoords[0]*width);
+        emitVertex(vWidth, uvCoords[3]*height, uvCoords[2]*width);
+        emitVertex(vHeight, uvCoords[5]*height, uvCoords[4]*width);
+        emitVertex(vEnd, uvCoords[7]*height, uvCoords[6]*width);
     } else
     {
-        vertices.emplace_back(vStart.x, vStart.y, vStart.z, uvCoords[0]*width, uvCoords[1]*height, blockSide, lightLevel);
-        vertices.emplace_back(vWidth.x, vWidth.y, vWidth.z, uvCoords[2]*width, uvCoords[3]*height, blockSide, lightLevel);
-        vertices.emplace_back(vHeight.x, vHeight.y, vHeight.z, uvCoords[4]*width, uvCoords[5]*height, blockSide, lightLevel);
-        vertices.emplace_back(vHeight.x, vHeight.y, vHeight.z, uvCoords[6]*width, uvCoords[7]*height, blockSide, lightLevel);
-        vertices.emplace_back(vEnd.x, vEnd.y, vEnd.z, uvCoords[8]*width, uvCoords[9]*height, blockSide, lightLevel);
-        vertices.emplace_back(vWidth.x, vWidth.y, vWidth.z, uvCoords[10]*width, uvCoords[11]*height, blockSide, lightLevel);
+        emitVertex(vStart, uvCoords[0]*width, uvCoords[1]*height);
+        emitVertex(vWidth, uvCoords[2]*width, uvCoords[3]*height);
+        emitVertex(vHeight, uvCoords[4]*width, uvCoords[5]*height);
+        emitVertex(vEnd, uvCoords[6]*width, uvCoords[7]*height);
     }
 
 }
-
-uint8_t ChunkMeshingSystem::getLightLevelAt(entt::registry& registry, const entt::entity& e_Chunk,
-                                          ChunkComponent& chunkComp, const int x, const int y,
-                                          const int z) {
-    // x, y, z is the coordinate of the voxel with the face being inspected
-    GLubyte lightLevel;
-
-    if (x == -1) // x = -1 in current chunk refers to x = CW-1 in western neighbor
-        if (chunkComp.neighborEntities[WEST] != entt::null)
-            lightLevel = registry.get<ChunkComponent>(chunkComp.neighborEntities[WEST]).lightAt(CHUNK_WIDTH - 1, y, z);
-        else
-            lightLevel = 0xFF;
-    else if (x == CHUNK_WIDTH) // x = CW is x = 0 in eastern neighbor
-        if (chunkComp.neighborEntities[EAST] != entt::null)
-            lightLevel = registry.get<ChunkComponent>(chunkComp.neighborEntities[EAST]).lightAt(0, y, z);
-        else
-            lightLevel = 0xFF;
-    else if (y == -1) // let's just give it direct sunlight at bottom, no one will see for now
-        lightLevel = 0xFF;
-    else if (y == CHUNK_HEIGHT) // always direct sunlight
-        lightLevel = 0xFF;
-    else if (z == -1) // z = -1 is z = CW-1 in southern neighbor
-        if (chunkComp.neighborEntities[SOUTH] != entt::null)
-            lightLevel = registry.get<ChunkComponent>(chunkComp.neighborEntities[SOUTH]).lightAt(x, y, CHUNK_WIDTH - 1);
-        else
-            lightLevel = 0xFF;
-    else if (z == CHUNK_WIDTH) // z = CW is z = 0 in northern neighbor
-        if (chunkComp.neighborEntities[NORTH] != entt::null)
-            lightLevel = registry.get<ChunkComponent>(chunkComp.neighborEntities[NORTH]).lightAt(x, y, 0);
-        else
-            lightLevel = 0xFF;
-    else
-        lightLevel = chunkComp.lightAt(x, y, z);
-
-    return lightLevel;
-}
\ No newline at end of file
@@ -7,31 +7,63 @@
 #include "Block.h"
 #include "Texture.h"
 #include "Components.h"
+#include "JobSystem.h"
+#include "ChunkSnapshot.h"
+
+// how a chunk's faces are found and merged into quads, both produce the same quads in the same order
+enum class MeshingMethod {
+    GREEDY, // compares face types cell by cell in every slice
+    BINARY_GREEDY // finds faces with occupancy bit masks, merges quads with bit scans
+};
 
 class ChunkMeshingSystem {
 public:
-    ChunkMeshingSystem();
+    ChunkMeshingSystem(JobSystem& jobSystem);
     ~ChunkMeshingSystem();
 
     void update(entt::registry& registry);
-    void initNewChunk(const entt::entity& e_Chunk, entt::registry& registry);
+    // rebuilds the given mesh parts of chunk's MeshComponent and marks it MESHED
+    // faces toward a loaded neighbour are culled against its blocks, faces toward an unloaded one are drawn
+    void meshChunk(entt::entity chunk, entt::registry& registry, MeshingMethod method,
+                   uint64_t parts = ALL_MESH_PARTS);
+    void setMeshingMethod(MeshingMethod method) { m_MeshingMethod = method; }
 private:
-    void constructMesh(entt::entity chunk, entt::registry& registry);
-    void greedyMesh(entt::entity chunk, entt::registry& registry);
-    void appendQuad(glm::vec3 v1, glm::vec3 v2, glm::vec3 v3, glm::vec3 v4, BlockType block,
+    JobSystem& m_JobSystem;
+    MeshingMethod m_MeshingMethod = MeshingMethod::BINARY_GREEDY;
+
+    // true if all four horizontal neighbours are loaded and have reached stage
+    static bool neighborsReached(entt::registry& registry, const ChunkComponent& chunkComp, ChunkStatus stage);
+
+    using PartVertices = std::array<std::vector<texArrayVertex>, MESH_PARTS>;
+    // a chunk meshed by a worker, which only reads the snapshot and writes partVertices
+    struct MeshJob {
+        entt::entity chunk;
+        uint64_t parts;
+        ChunkSnapshot snapshot;
+        PartVertices partVertices;
+    };
+
+    // meshing below only reads the snapshot, so it is safe off the main thread
+    void buildMesh(const ChunkSnapshot& snapshot, MeshingMethod method, uint64_t parts,
+                   PartVertices& partVertices) const;
+    // main thread: splices the built parts into chunk's MeshComponent and marks it MESHED,
+    // sections rebuilt whole are no longer dirty
+    static void applyMesh(entt::registry& registry, entt::entity chunk, uint64_t parts,
+                          const PartVertices& partVertices);
+
+    // both append the quads of the requested parts to partVertices
+    void greedyMesh(const ChunkSnapshot& snapshot, uint64_t parts, PartVertices& partVertices) const;
+    void binaryGreedyMesh(const ChunkSnapshot& snapshot, uint64_t parts, PartVertices& partVertices) const;
+    // corners are chunk-local
+    void appendQuad(glm::ivec3 v1, glm::ivec3 v2, glm::ivec3 v3, glm::ivec3 v4, BlockType block,
                          int width, int height,
                          Direction dir, std::vector<texArrayVertex>& vertices,
-                         uint8_t lightLevel);
+                         uint8_t lightLevel) const;
 
-    uint8_t getLightLevelAt(entt::registry& registry, const entt::entity& e_Chunk,
-                                                ChunkComponent& chunkComp, const int x, const int y,
-                                                const int z);
-    float uvCoords[12] = {
-            0.0f, 0.0f, // first triangle on face
+    float uvCoords[8] = { // quad corners: start, + width, + height, end
+            0.0f, 0.0f,
             1.0f, 0.0f,
             0.0f, 1.0f,
-            0.0f, 1.0f, // second triangle on face
-            1.0f, 1.0f,
-            1.0f, 0.0f
+            1.0f, 1.0f
     };
 };
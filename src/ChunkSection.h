@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Chunk.h"
+#include "Block.h"
+#include "PaletteStorage.h"
+
+// 16x16x16 slice of a chunk, local coordinates (y in [0, SECTION_HEIGHT))
+// all-air and single-type sections keep no voxel array, only their palette entry
+class ChunkSection {
+public:
+    ChunkSection(BlockType fill = AIR)
+        : blocks(SECTION_VOLUME, fill) {}
+    explicit ChunkSection(PaletteStorage storage)
+        : blocks(std::move(storage)) {}
+
+    BlockType typeAt(int x, int y, int z) const {
+        return blocks.get(x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH));
+    }
+    void setBlock(int x, int y, int z, BlockType type) {
+        blocks.set(x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH), type);
+    }
+
+    bool isEmpty() const { return blocks.isUniform() && blocks.palette()[0] == AIR; }
+    bool isUniform() const { return blocks.isUniform(); }
+    BlockType uniformType() const { return blocks.palette()[0]; } // only meaningful if isUniform()
+    void compact() { blocks.compact(); }
+
+    const PaletteStorage& storage() const { return blocks; }
+
+private:
+    PaletteStorage blocks;
+};
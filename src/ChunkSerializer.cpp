@@ -0,0 +1,128 @@
+#include "ChunkSerializer.h"
+
+#include <stdexcept>
+
+namespace {
+    template <typename T>
+    void writeLE(std::ostream& out, T value)
+    {
+        uint64_t bits = static_cast<uint64_t>(value);
+        char bytes[sizeof(T)];
+        for (size_t i = 0; i < sizeof(T); i++)
+            bytes[i] = static_cast<char>((bits >> (8 * i)) & 0xFF);
+        out.write(bytes, sizeof(T));
+    }
+
+    template <typename T>
+    T readLE(std::istream& in)
+    {
+        unsigned char bytes[sizeof(T)];
+        if (not in.read(reinterpret_cast<char*>(bytes), sizeof(T)))
+            throw std::runtime_error("[Runtime Exception] Truncated chunk record");
+        uint64_t bits = 0;
+        for (size_t i = 0; i < sizeof(T); i++)
+            bits |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+        return static_cast<T>(bits);
+    }
+}
+
+void ChunkSerializer::writeChunk(std::ostream& out, const ChunkPayload& payload)
+{
+    const ChunkComponent& chunk = payload.chunk;
+    writeLE<uint32_t>(out, MAGIC);
+    writeLE<uint16_t>(out, VERSION);
+    writeLE<int32_t>(out, static_cast<int32_t>(payload.chunkPos.x));
+    writeLE<int32_t>(out, static_cast<int32_t>(payload.chunkPos.z));
+
+    for (int sectionIdx = 0; sectionIdx < CHUNK_SECTIONS; sectionIdx++)
+    {
+        const PaletteStorage& storage = chunk.sectionAt(sectionIdx).storage();
+        writeLE<uint8_t>(out, static_cast<uint8_t>(storage.bitsPerIndex()));
+        writeLE<uint16_t>(out, static_cast<uint16_t>(storage.palette().size()));
+        for (BlockType type : storage.palette())
+            writeLE<uint16_t>(out, static_cast<uint16_t>(type));
+        writeLE<uint32_t>(out, static_cast<uint32_t>(storage.data().size()));
+        for (uint64_t word : storage.data())
+            writeLE<uint64_t>(out, word);
+    }
+
+    for (int i = 0; i < CHUNK_WIDTH * CHUNK_WIDTH; i++)
+        writeLE<uint8_t>(out, static_cast<uint8_t>(chunk.biomeMap[i]));
+
+    // light is mostly long runs of full sunlight (sky) and darkness (underground)
+    std::vector<std::pair<uint8_t, uint16_t>> runs;
+    for (uint8_t level : chunk.lightMap)
+    {
+        if (not runs.empty() && runs.back().first == level && runs.back().second < UINT16_MAX)
+            runs.back().second++;
+        else
+            runs.emplace_back(level, 1);
+    }
+    writeLE<uint32_t>(out, static_cast<uint32_t>(runs.size()));
+    for (const auto& [level, length] : runs)
+    {
+        writeLE<uint8_t>(out, level);
+        writeLE<uint16_t>(out, length);
+    }
+}
+
+bool ChunkSerializer::readChunk(std::istream& in, ChunkPayload& payload)
+{
+    if (in.peek() == std::char_traits<char>::eof())
+        return false;
+    if (readLE<uint32_t>(in) != MAGIC)
+        throw std::runtime_error("[Runtime Exception] Not a chunk record");
+    if (readLE<uint16_t>(in) != VERSION)
+        throw std::runtime_error("[Runtime Exception] Unsupported chunk record version");
+    int32_t chunkX = readLE<int32_t>(in);
+    int32_t chunkZ = readLE<int32_t>(in);
+    payload.chunkPos = glm::vec3(chunkX, 0, chunkZ);
+
+    std::array<ChunkSection, CHUNK_SECTIONS> sections;
+    for (ChunkSection& section : sections)
+    {
+        int bitsPerIndex = readLE<uint8_t>(in);
+        std::vector<BlockType> palette(readLE<uint16_t>(in));
+        for (BlockType& type : palette)
+        {
+            uint16_t value = readLE<uint16_t>(in);
+            // only registered types have a block, setBlock below looks every one of them up
+            if (value >= TOTAL_BLOCK_TYPES
+                || BlockPool::getPoolInstance().getBlockPtr(static_cast<BlockType>(value)) == nullptr)
+                throw std::runtime_error("[Runtime Exception] Unknown block type in chunk record");
+            type = static_cast<BlockType>(value);
+        }
+        std::vector<uint64_t> words(readLE<uint32_t>(in));
+        for (uint64_t& word : words)
+            word = readLE<uint64_t>(in);
+        section = ChunkSection(PaletteStorage::fromRaw(SECTION_VOLUME, std::move(palette), bitsPerIndex,
+                                                       std::move(words)));
+    }
+    payload.chunk.setBlock(std::move(sections));
+
+    payload.chunk.biomeMap.resize(CHUNK_WIDTH * CHUNK_WIDTH);
+    for (BiomeType& biome : payload.chunk.biomeMap)
+    {
+        uint8_t value = readLE<uint8_t>(in);
+        if (value > SandBiome)
+            throw std::runtime_error("[Runtime Exception] Unknown biome type in chunk record");
+        biome = static_cast<BiomeType>(value);
+    }
+
+    std::vector<uint8_t>& lightMap = payload.chunk.lightMap;
+    size_t lightIdx = 0;
+    uint32_t runCount = readLE<uint32_t>(in);
+    for (uint32_t run = 0; run < runCount; run++)
+    {
+        uint8_t level = readLE<uint8_t>(in);
+        uint16_t length = readLE<uint16_t>(in);
+        if (lightIdx + length > lightMap.size())
+            throw std::runtime_error("[Runtime Exception] Light map overflows chunk");
+        std::fill_n(lightMap.begin() + lightIdx, length, level);
+        lightIdx += length;
+    }
+    if (lightIdx != lightMap.size())
+        throw std::runtime_error("[Runtime Exception] Light map does not cover chunk");
+    payload.chunk.setStatus(ChunkStatus::LIT); // records are written after lighting
+    return true;
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include "ChunkGenerator.h"
+
+// binary chunk records, little endian, appended back to back in region files (see tools/pregen.cpp)
+// record: magic, version, chunk x/z, 8 palette sections, biome map, run-length encoded light map
+// the light map is stored as generated (chunk-local, not yet stitched with neighbours)
+class ChunkSerializer {
+public:
+    static void writeChunk(std::ostream& out, const ChunkPayload& payload);
+    // returns false at a clean end of stream, throws on truncated or malformed records
+    // (including block types BlockPool has not registered and unknown biomes)
+    static bool readChunk(std::istream& in, ChunkPayload& payload);
+
+    static constexpr uint32_t MAGIC = 0x4B434D31; // "1MCK"
+    static constexpr uint16_t VERSION = 1;
+};
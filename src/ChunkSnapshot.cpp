@@ -0,0 +1,74 @@
+#include "ChunkSnapshot.h"
+
+#include <algorithm>
+#include <cstring>
+
+ChunkSnapshot::ChunkSnapshot(entt::registry& registry, entt::entity e_Chunk, uint8_t sections)
+    : m_Blocks(PADDED_WIDTH * PADDED_HEIGHT * PADDED_WIDTH, AIR),
+      m_Light(PADDED_WIDTH * PADDED_HEIGHT * PADDED_WIDTH, 0xFF),
+      m_Solid(PADDED_HEIGHT * PADDED_WIDTH, 0)
+{
+    const ChunkComponent& chunkComp = registry.get<ChunkComponent>(e_Chunk);
+    // the sections above and below are copied as well, their boundary layers are seen from the requested ones
+    uint8_t copied = sections | (sections << 1) | (sections >> 1);
+
+    // the chunk itself: sections are unpacked whole, then copied a row of x at a time
+    // solid rows come straight from the packed indices
+    BlockType sectionBlocks[SECTION_VOLUME];
+    uint16_t sectionSolid[SECTION_HEIGHT * CHUNK_WIDTH];
+    for (int sectionIdx = 0; sectionIdx < CHUNK_SECTIONS; sectionIdx++)
+    {
+        const ChunkSection& section = chunkComp.sectionAt(sectionIdx);
+        const PaletteStorage& storage = section.storage();
+        m_SectionUniform[sectionIdx] = section.isUniform();
+        if (not (copied & (1 << sectionIdx)))
+            continue;
+        storage.unpack(sectionBlocks);
+        std::vector<bool> solidEntries;
+        for (BlockType type : storage.palette())
+            solidEntries.push_back(type != AIR);
+        storage.matchMask(solidEntries, sectionSolid);
+        for (int y = 0; y < SECTION_HEIGHT; y++)
+            for (int z = 0; z < CHUNK_WIDTH; z++)
+            {
+                int chunkY = sectionIdx * SECTION_HEIGHT + y;
+                std::copy_n(&sectionBlocks[(y * CHUNK_WIDTH + z) * CHUNK_WIDTH], CHUNK_WIDTH,
+                            &m_Blocks[index(0, chunkY, z)]);
+                m_Solid[(chunkY + 1) * PADDED_WIDTH + z + 1] = sectionSolid[y * CHUNK_WIDTH + z] << 1;
+            }
+    }
+    for (int y = 0; y < CHUNK_HEIGHT; y++)
+        for (int z = 0; z < CHUNK_WIDTH; z++)
+            if (copied & (1 << (y / SECTION_HEIGHT)))
+                std::memcpy(&m_Light[index(0, y, z)], &chunkComp.lightMap[(y * CHUNK_WIDTH + z) * CHUNK_WIDTH],
+                            CHUNK_WIDTH);
+
+    // the neighbours' voxels touching each border
+    for (int dir = NORTH; dir <= EAST; dir++)
+    {
+        entt::entity e_Neighbor = chunkComp.neighborEntities[dir];
+        if (e_Neighbor == entt::null)
+            continue;
+        const ChunkComponent& neighborComp = registry.get<ChunkComponent>(e_Neighbor);
+        bool alongX = (dir == NORTH || dir == SOUTH); // border runs along x
+        int outside = (dir == WEST || dir == SOUTH) ? -1 : CHUNK_WIDTH; // padded coordinate of the border
+        int inNeighbor = (dir == WEST || dir == SOUTH) ? CHUNK_WIDTH - 1 : 0; // same voxels in the neighbour
+        for (int y = 0; y < CHUNK_HEIGHT; y++)
+        {
+            if (not (copied & (1 << (y / SECTION_HEIGHT))))
+                continue;
+            for (int i = 0; i < CHUNK_WIDTH; i++)
+            {
+                int x = alongX ? i : inNeighbor;
+                int z = alongX ? inNeighbor : i;
+                int padded = alongX ? index(i, y, outside) : index(outside, y, i);
+                BlockType type = neighborComp.typeAt(x, y, z);
+                m_Blocks[padded] = type;
+                m_Light[padded] = neighborComp.lightMap[(y * CHUNK_WIDTH + z) * CHUNK_WIDTH + x];
+                uint32_t& solidRow = alongX ? m_Solid[(y + 1) * PADDED_WIDTH + outside + 1]
+                                            : m_Solid[(y + 1) * PADDED_WIDTH + i + 1];
+                solidRow |= static_cast<uint32_t>(type != AIR) << ((alongX ? i : outside) + 1);
+            }
+        }
+    }
+}
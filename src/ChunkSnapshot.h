@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+#include <entt/entt.hpp>
+#include "Block.h"
+#include "Chunk.h"
+#include "ChunkComponent.h"
+
+// immutable copy of one chunk's blocks and light with a one voxel border taken from its four neighbours
+// (18x130x18), taken on the main thread so meshing jobs never read the registry or live chunk data
+// the border above/below the chunk and toward unloaded neighbours is AIR with full light, like the sky
+class ChunkSnapshot {
+public:
+    static const int PADDED_WIDTH = CHUNK_WIDTH + 2;
+    static const int PADDED_HEIGHT = CHUNK_HEIGHT + 2;
+
+    // only the given sections (bit per section) and the layers bordering them are copied, enough to mesh them
+    ChunkSnapshot(entt::registry& registry, entt::entity e_Chunk, uint8_t sections = (1 << CHUNK_SECTIONS) - 1);
+
+    // x, z in [-1, CHUNK_WIDTH], y in [-1, CHUNK_HEIGHT]; the four vertical corner columns are never filled
+    BlockType typeAt(int x, int y, int z) const {
+        return m_Blocks[index(x, y, z)];
+    }
+    uint8_t lightAt(int x, int y, int z) const {
+        return m_Light[index(x, y, z)];
+    }
+    // bit x + 1 set where (x, y, z) is not AIR, for x in [-1, CHUNK_WIDTH]
+    uint32_t solidRow(int y, int z) const {
+        return m_Solid[(y + 1) * PADDED_WIDTH + z + 1];
+    }
+    // single-type sections of the chunk itself, lets meshers skip their interior
+    bool isSectionUniform(int sectionIdx) const {
+        return m_SectionUniform[sectionIdx];
+    }
+
+private:
+    std::vector<BlockType> m_Blocks;
+    std::vector<uint8_t> m_Light;
+    std::vector<uint32_t> m_Solid; // one row of x per (y, z)
+    std::array<bool, CHUNK_SECTIONS> m_SectionUniform;
+
+    static int index(int x, int y, int z) {
+        return (x + 1) + (z + 1) * PADDED_WIDTH + (y + 1) * PADDED_WIDTH * PADDED_WIDTH;
+    }
+};
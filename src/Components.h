@@ -1,7 +1,10 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <memory>
+#include <cmath>
+#include <cstring>
 #include <shared_mutex>
 #include <glm/vec3.hpp>
 #include "Block.h"
@@ -10,6 +13,8 @@
 #include "Biome.h"
 #include "Camera.h"
 #include "BlockPool.h"
+#include "ChunkComponent.h"
+#include "ChunkGrid.h"
 
 struct PositionComponent
 {
@@ -17,90 +22,83 @@ struct PositionComponent
     glm::vec3 pos;
 };
 
-struct ChunkComponent
-{
-private:
-    bool changed = false; // useful to determine if new meshes should be generated
-    std::vector<const Block*> blocks; // = std::vector<BlockType>(CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_WIDTH, AIR);
-
-public:
-    bool hasChanged() const {
-        return changed;
-    }
-
-    void markChangesResolved() {
-        changed = false;
-    }
-    // TODO: use getter const {} and setter method, encapsulate hasChanged (private, public getter)
-
-    // "points" to neighboring chunks, but not necessary to use pointers as entities are just integers
-    // convention: indexed with [NORTH, SOUTH, WEST, EAST] per enum
-    std::vector<entt::entity> neighborEntities {entt::null, entt::null, entt::null, entt::null};
-
-    // include array of 8 bit enums corresponding to block types
-    // classifies biome for each x,z index
-    std::vector<BiomeType> biomeMap; // = std::vector<BiomeType>(CHUNK_WIDTH * CHUNK_WIDTH, GrassBiome);
-
-    // reference to pointer to constant block
-    const Block* blockAt(int x, int y, int z) const {
-        return blocks[x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH)];
-    }
-    const Block* blockAt(const glm::ivec3& blockPos) const {
-        return blocks[blockPos.x + (blockPos.z * CHUNK_WIDTH) + (blockPos.y * CHUNK_WIDTH * CHUNK_WIDTH)];
-    }
-
-    void setBlock(std::vector<const Block*>& blockArr) {
-        blocks = blockArr;
-        changed = true;
-    }
-    void setBlock(const glm::ivec3& blockPos, const BlockType type) {
-        if (blockAt(blockPos)->typeOf() == type) // avoid meshing/lighting again if no changes
-            return;
-
-        blocks[blockPos.x + (blockPos.z * CHUNK_WIDTH) + (blockPos.y * CHUNK_WIDTH * CHUNK_WIDTH)]
-                = BlockPool::getPoolInstance().getBlockPtr(type);
-        changed = true; // note updated block state
-    }
+// chunk meshes are built per section, and each section's mesh in parts: the faces lying on each horizontal chunk
+// border (indexed NORTH..EAST like Direction), then all other faces; part = section * PARTS_PER_SECTION + that index
+// an edited section is rebuilt alone, a border part only when the neighbour behind it loads or unloads
+const int INTERIOR_MESH_PART = 4;
+const int PARTS_PER_SECTION = 5;
+const int MESH_PARTS = CHUNK_SECTIONS * PARTS_PER_SECTION;
+const uint64_t ALL_MESH_PARTS = (uint64_t{1} << MESH_PARTS) - 1;
 
-    // sunlight corresponds to the bits 0000XXXX
-    // torchlight corresponds to bits XXXX0000
-    std::vector<uint8_t> lightMap = std::vector<uint8_t>(CHUNK_WIDTH * CHUNK_HEIGHT * CHUNK_WIDTH, 0);
-    void clearLightMap() {
-        memset(&lightMap[0], static_cast<uint8_t>(0), lightMap.size());
-    }
-    int getSunlight(int x, int y, int z) {
-        return lightMap[x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH)] & 0xF;
-    }
-    void setSunlight(int x, int y, int z, int val) {
-        lightMap[x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH)]
-                = (lightMap[x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH)] & 0xF0) | val;
-    }
-    int getTorchlight(int x, int y, int z) {
-        return (lightMap[x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH)] >> 4) & 0xF;
-    }
-    void setTorchlight(int x, int y, int z, int val) {
-        lightMap[x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH)]
-                = (lightMap[x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH)] & 0xF) | (val << 4);
-    }
-    uint8_t lightAt(int x, int y, int z) {
-        return lightMap[x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH)];
-    }
-};
+// every part of the given sections (bit per section)
+constexpr uint64_t sectionMeshParts(uint8_t sections)
+{
+    uint64_t parts = 0;
+    for (int sectionIdx = 0; sectionIdx < CHUNK_SECTIONS; sectionIdx++)
+        if (sections & (1 << sectionIdx))
+            parts |= uint64_t{(1 << PARTS_PER_SECTION) - 1} << (sectionIdx * PARTS_PER_SECTION);
+    return parts;
+}
+// sections with any of parts
+constexpr uint8_t meshPartSections(uint64_t parts)
+{
+    uint8_t sections = 0;
+    for (int sectionIdx = 0; sectionIdx < CHUNK_SECTIONS; sectionIdx++)
+        if (parts & sectionMeshParts(1 << sectionIdx))
+            sections |= 1 << sectionIdx;
+    return sections;
+}
+// the part facing dir in every section
+constexpr uint64_t borderMeshParts(Direction dir)
+{
+    uint64_t parts = 0;
+    for (int sectionIdx = 0; sectionIdx < CHUNK_SECTIONS; sectionIdx++)
+        parts |= uint64_t{1} << (sectionIdx * PARTS_PER_SECTION + dir);
+    return parts;
+}
+// the part facing dir in the section holding layer y
+constexpr uint64_t borderMeshPart(Direction dir, int y)
+{
+    return uint64_t{1} << ((y / SECTION_HEIGHT) * PARTS_PER_SECTION + dir);
+}
 
 // destructor being called a lot... does this have to do with initializing each entity's mesh component / overwriting?
 struct MeshComponent // can add more VBOs for different rendering processes
 {
     // shader, texture, VAO stored in RenderSystem for each VBO
-    bool initialized = false; // can we construct meshes on another thread? only if uninitialized, else need next frame
-    bool startedInit = false;
-    bool mustUpdateBuffer = true; // if vertex data different, must update buffer for GPU
-    unsigned int blockVBO; // VBO for block
-    std::vector<texArrayVertex> chunkVertices; // vertex data
+    // chunk meshes are uploaded while their ChunkComponent status is MESHED, a section at a time
+    std::array<unsigned int, CHUNK_SECTIONS> sectionVBOs {}; // 0 until RenderSystem creates them
+    // vertices currently in each VBO, lag sectionVertices while an upload is deferred
+    std::array<size_t, CHUNK_SECTIONS> uploadedVertexCounts {};
+    // vertex data per section, the section's parts stored back to back in part order
+    std::array<std::vector<texArrayVertex>, CHUNK_SECTIONS> sectionVertices;
+    std::array<size_t, MESH_PARTS> partSizes {}; // vertices of each part
+    uint64_t staleParts = 0; // bit per part to rebuild although the chunk's own blocks and light did not change
+    uint8_t unuploadedSections = 0; // bit per section remeshed since its last upload
+
+    // swaps the vertices of one part for newly meshed ones
+    void replacePart(int part, const std::vector<texArrayVertex>& vertices) {
+        int firstPart = part - part % PARTS_PER_SECTION;
+        size_t partStart = 0;
+        for (int i = firstPart; i < part; i++)
+            partStart += partSizes[i];
+        std::vector<texArrayVertex>& sectionVerts = sectionVertices[part / PARTS_PER_SECTION];
+        auto partBegin = sectionVerts.begin() + static_cast<std::ptrdiff_t>(partStart);
+        sectionVerts.erase(partBegin, partBegin + static_cast<std::ptrdiff_t>(partSizes[part]));
+        sectionVerts.insert(sectionVerts.begin() + static_cast<std::ptrdiff_t>(partStart),
+                            vertices.begin(), vertices.end());
+        partSizes[part] = vertices.size();
+    }
+    size_t vertexCount() const {
+        size_t count = 0;
+        for (const std::vector<texArrayVertex>& vertices : sectionVertices)
+            count += vertices.size();
+        return count;
+    }
 
     // destructor needed? gl objects/programs
     // disable copying and enable moving
-    MeshComponent(bool b, unsigned int vbo, std::vector<texArrayVertex> vertices)
-        : mustUpdateBuffer(b), blockVBO(std::move(vbo)), chunkVertices(vertices) {};
+    MeshComponent() = default;
     MeshComponent(const MeshComponent&) = delete;
     // swap & pop means destructor called twice --> must call glDeleteBuffers outside
     MeshComponent operator=(const MeshComponent&) = delete;
@@ -109,6 +107,36 @@ struct MeshComponent // can add more VBOs for different rendering processes
     // eventually may need bool to track if VBO needs initializing
 };
 
+// per-frame time budgets for chunk streaming (adjustable at runtime) and last frame's statistics, one per world
+struct FrameBudgetComponent
+{
+    // milliseconds a stage may spend per frame, remaining work carries over to the next frame
+    double commitBudgetMs = 2.0;
+    double meshBudgetMs = 4.0;
+    double uploadBudgetMs = 2.0;
+
+    // work done and work deferred during the last frame
+    int chunksCommitted = 0;
+    int commitsDeferred = 0;
+    int chunksMeshed = 0;
+    int meshesDeferred = 0;
+    int sectionsUploaded = 0; // uploads are counted per section VBO
+    int sectionUploadsDeferred = 0;
+};
+
+// world clock driving the day/night cycle, one per world
+// only the sky brightness uniform and clear color follow it: light maps and meshes store absolute levels
+struct TimeOfDayComponent
+{
+    float timeOfDay = 0.3f; // fraction of a day: 0 midnight, 0.25 sunrise, 0.5 noon, 0.75 sunset
+    float dayLengthSeconds = 600.0f;
+    float timeScale = 1.0f; // multiplier on real time, raised while the fast-forward key is held
+
+    void advance(float deltaTime) {
+        timeOfDay = std::fmod(timeOfDay + timeScale * deltaTime / dayLengthSeconds, 1.0f);
+    }
+};
+
 struct CameraComponent
 {
     std::shared_ptr<Camera> camera;
@@ -120,41 +148,38 @@ struct ChunkMapComponent
 {
 private:
     entt::registry& m_Registry;
-    std::unordered_map<int, std::unordered_map<int, entt::entity>> m_ChunkMap; // typedef ChunkMap?
+    // chunks live in the player-centred toroidal grid, ChunkLoaderSystem unloads the old window before
+    // committing chunks of the new one so a chunk's slot is always free when it is inserted
+    ChunkGrid m_Grid;
+
+    entt::entity find(int x, int z) const {
+        return m_Grid.find(x, z);
+    }
 public:
-    // if performance suffers, consider O(1) alternative
-//    std::map<std::pair<int, int>, entt::entity> m_ChunkMap;
     bool contains(const std::pair<int, int>& chunkLoc) const {
-        return m_ChunkMap.contains(chunkLoc.first) && m_ChunkMap.at(chunkLoc.first).contains(chunkLoc.second);
+        return find(chunkLoc.first, chunkLoc.second) != entt::null;
     }
-    void erase(const std::pair<int, int>& chunkLoc) {
-        auto& innermostMap = m_ChunkMap.at(chunkLoc.first);
-        innermostMap.erase(chunkLoc.second); // erase entry of chunk
-
-        if (innermostMap.empty()) // erase outermost map if inner has no more entries
-            m_ChunkMap.erase(chunkLoc.first);
+    bool erase(const std::pair<int, int>& chunkLoc) {
+        return m_Grid.clear(chunkLoc.first, chunkLoc.second);
     }
-    entt::entity& operator[](const std::pair<int, int>& chunkLoc)
+    // chunk entity at chunkLoc, entt::null if not loaded
+    entt::entity operator[](const std::pair<int, int>& chunkLoc) const
     {
-        return m_ChunkMap[chunkLoc.first][chunkLoc.second];
-    }
-    entt::entity& operator[](std::pair<int, int>&& chunkLoc)
-    {
-        return m_ChunkMap[chunkLoc.first][chunkLoc.second];
+        return find(chunkLoc.first, chunkLoc.second);
     }
     ChunkMapComponent(entt::registry& registry)
         : m_Registry(registry) {};
     // copy constructor
     ChunkMapComponent(const ChunkMapComponent& other)
-        : m_Registry(other.m_Registry), m_ChunkMap(other.m_ChunkMap) {};
+        : m_Registry(other.m_Registry), m_Grid(other.m_Grid) {};
     // should make this move assignable & constructable for entt
     ChunkMapComponent(ChunkMapComponent&& other)
-        : m_Registry(other.m_Registry), m_ChunkMap(std::move(other.m_ChunkMap))
+        : m_Registry(other.m_Registry), m_Grid(other.m_Grid)
     {};
     ChunkMapComponent& operator=(ChunkMapComponent&& other) {
         if (this == &other)
             return *this;
-        this->m_ChunkMap = std::move(other.m_ChunkMap);
+        this->m_Grid = other.m_Grid;
         this->m_Registry = std::move(other.m_Registry);
         return *this;
     };
@@ -168,21 +193,13 @@ public:
     }
     static std::pair<int, int> chunkOf(const glm::vec3& pos)
     {
-        int xChunk = static_cast<int>(pos.x) / CHUNK_WIDTH * CHUNK_WIDTH;
-        int zChunk = static_cast<int>(pos.z) / CHUNK_WIDTH * CHUNK_WIDTH;
-        // above statement maps to upper right corner (instead of bottom left) for negative values
-        if (pos.x < 0) xChunk -= CHUNK_WIDTH;
-        if (pos.z < 0) zChunk -= CHUNK_WIDTH;
-
-        return std::make_pair(xChunk, zChunk);
+        return chunkOf(glm::ivec3(glm::floor(pos)));
     }
     static std::pair<int, int> chunkOf(const glm::ivec3& pos)
     {
-        int xChunk = pos.x / CHUNK_WIDTH * CHUNK_WIDTH;
-        int zChunk = pos.z / CHUNK_WIDTH * CHUNK_WIDTH;
-        // above statement maps to upper right corner (instead of bottom left) for negative values
-        if (pos.x < 0) xChunk -= CHUNK_WIDTH;
-        if (pos.z < 0) zChunk -= CHUNK_WIDTH;
+        // floor division: negative coordinates map to bottom left corner (e.g. -1 and -16 lie in chunk -16)
+        int xChunk = ((pos.x >= 0) ? pos.x : pos.x - (CHUNK_WIDTH - 1)) / CHUNK_WIDTH * CHUNK_WIDTH;
+        int zChunk = ((pos.z >= 0) ? pos.z : pos.z - (CHUNK_WIDTH - 1)) / CHUNK_WIDTH * CHUNK_WIDTH;
 
         return std::make_pair(xChunk, zChunk);
     }
@@ -191,15 +208,13 @@ public:
     {
         auto chunkLoc = chunkOf(pos);
         // account for indexing within chunk (0,0,0) to (WIDTH-1, HEIGHT-1, WIDTH-1)
-        glm::ivec3 integralPosInChunk (static_cast<int>(pos.x) - chunkLoc.first,
-                                static_cast<int>(pos.y),
-                                static_cast<int>(pos.z) - chunkLoc.second);
+        glm::ivec3 integralPosInChunk = glm::ivec3(glm::floor(pos)) - glm::ivec3(chunkLoc.first, 0, chunkLoc.second);
 
-        if (!isLoaded(chunkLoc)) // chunk does not exist
+        entt::entity e_Chunk = find(chunkLoc.first, chunkLoc.second);
+        if (e_Chunk == entt::null) // chunk does not exist
             throw std::runtime_error("[Runtime Exception] ChunkMapComponent::blockAt input parameter pos refers to unloaded chunk.");
 
-        ChunkMapComponent& self = *this;
-        ChunkComponent& chunkComp = m_Registry.get<ChunkComponent>(self[chunkLoc]);
+        ChunkComponent& chunkComp = m_Registry.get<ChunkComponent>(e_Chunk);
         return chunkComp.blockAt(integralPosInChunk.x, integralPosInChunk.y, integralPosInChunk.z);
     }
     void setBlock(const glm::ivec3& blockPos, const BlockType type)
@@ -207,22 +222,44 @@ public:
         ChunkMapComponent& self = *this;
         auto chunkLoc = chunkOf(blockPos);
         ChunkComponent& chunkComp = m_Registry.get<ChunkComponent>(self[chunkLoc]);
-        chunkComp.setBlock(blockPos, type);
+        // chunk stores blocks in local coordinates
+        glm::ivec3 localPos(blockPos.x - chunkLoc.first, blockPos.y, blockPos.z - chunkLoc.second);
+        if (chunkComp.typeAt(localPos.x, localPos.y, localPos.z) == type)
+            return;
+        chunkComp.setBlock(localPos, type);
+
+        // a border block is culled against by the neighbour's faces on the shared border, only that part goes stale
+        auto markNeighbor = [&](Direction dir, Direction dirTowardEditedChunk) {
+            entt::entity e_Neighbor = chunkComp.neighborEntities[dir];
+            if (e_Neighbor == entt::null)
+                return;
+            if (MeshComponent* neighborMesh = m_Registry.try_get<MeshComponent>(e_Neighbor))
+                neighborMesh->staleParts |= borderMeshPart(dirTowardEditedChunk, localPos.y);
+        };
+        if (localPos.x == 0)
+            markNeighbor(WEST, EAST);
+        else if (localPos.x == CHUNK_WIDTH - 1)
+            markNeighbor(EAST, WEST);
+        if (localPos.z == 0)
+            markNeighbor(SOUTH, NORTH);
+        else if (localPos.z == CHUNK_WIDTH - 1)
+            markNeighbor(NORTH, SOUTH);
     }
 
     void deleteChunk(const std::pair<int, int>& chunkLoc)
     {
-        if (not this->contains(chunkLoc))
+        if (not this->erase(chunkLoc)) // remove from lookup table
             throw std::runtime_error("[Runtime Exception] ChunkMapComponent::deleteChunk input parameter chunkLoc refers to unloaded chunk.");
 
-        this->erase(chunkLoc); // remove from lookup search tree
         updateNeighbors(entt::null, chunkLoc); // update list of neighbors for surrounding chunk entities
     }
 
     void insertChunk(const entt::entity& e_Chunk, const std::pair<int, int>& chunkLoc)
     {
-        ChunkMapComponent& self = *this;
-        self[chunkLoc] = e_Chunk;
+        entt::entity occupant = m_Grid.occupant(chunkLoc.first, chunkLoc.second);
+        if (occupant != entt::null && m_Grid.find(chunkLoc.first, chunkLoc.second) != occupant)
+            throw std::runtime_error("[Runtime Exception] ChunkMapComponent::insertChunk grid slot of chunkLoc is held by another loaded chunk.");
+        m_Grid.set(chunkLoc.first, chunkLoc.second, e_Chunk);
         updateNeighbors(e_Chunk, chunkLoc); // update list of adjacent neighbors
     }
 
@@ -246,15 +283,17 @@ public:
             Direction dirTowardUpdatedChunk = oppositeDirIdx[i]; // e_Chunk is in this direction
             Direction dirTowardNeighbor = dirIdx[i];
 
-            if (not this->contains(neighborPos)) // skip iteration if no neighbor exists in memory
+            entt::entity e_AdjChunk = find(neighborPos.first, neighborPos.second);
+            if (e_AdjChunk == entt::null) // skip iteration if no neighbor exists in memory
                 continue;
 
             // update neighbor array corresponding to neighboring chunk entity
-            ChunkMapComponent& self = *this;
-            entt::entity e_AdjChunk = self[neighborPos];
             // check if has component..? should now but same crash
             std::vector<entt::entity>& adjChunkNeighbors = m_Registry.get<ChunkComponent>(e_AdjChunk).neighborEntities;
             adjChunkNeighbors[dirTowardUpdatedChunk] = e_Chunk;
+            // faces on the shared border were culled against the previous neighbour (or against air)
+            if (MeshComponent* adjMesh = m_Registry.try_get<MeshComponent>(e_AdjChunk))
+                adjMesh->staleParts |= borderMeshParts(dirTowardUpdatedChunk);
 
             // update neighbor array of current chunk entity
             if (e_Chunk != entt::null)
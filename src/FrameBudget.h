@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <stdexcept>
+#include <entt/entt.hpp>
+#include "Components.h"
+
+// measures how much of one stage's per-frame budget has been used
+class BudgetTimer {
+public:
+    explicit BudgetTimer(double budgetMs)
+        : m_BudgetMs(budgetMs), m_Start(std::chrono::steady_clock::now()) {}
+
+    double elapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_Start).count();
+    }
+    bool exhausted() const {
+        return elapsedMs() >= m_BudgetMs;
+    }
+
+private:
+    double m_BudgetMs;
+    std::chrono::steady_clock::time_point m_Start;
+};
+
+// the world's FrameBudgetComponent (created by World alongside the player)
+inline FrameBudgetComponent& getFrameBudget(entt::registry& registry)
+{
+    auto budgetView = registry.view<FrameBudgetComponent>();
+    for (auto e_Budget : budgetView)
+        return budgetView.get<FrameBudgetComponent>(e_Budget);
+    throw std::runtime_error("[Runtime Exception] No FrameBudgetComponent in registry");
+}
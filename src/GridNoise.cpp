@@ -0,0 +1,308 @@
+#include "GridNoise.h"
+
+#include <stdexcept>
+
+#if defined(__SSE4_1__)
+#include <smmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// the SIMD path repeats FastNoiseLite's float operations in the same order, which keeps both paths bit-identical
+// as long as the compiler may not fuse multiply-adds (targets with FMA, e.g. -march=native, need -ffp-contract=off)
+namespace {
+    const int PrimeX = 501125321;
+    const int PrimeY = 1136930381;
+    const int HashMultiplier = 0x27d4eb2d;
+
+    // FastNoiseLite::Lookup<float>::Gradients2D (private there, copied verbatim)
+    alignas(16) const float Gradients2D[256] = {
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f,
+        0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f,
+        0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f,
+        -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f,
+        -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f,
+        -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        0.38268343236509f, 0.923879532511287f, 0.923879532511287f, 0.38268343236509f, 0.923879532511287f, -0.38268343236509f, 0.38268343236509f, -0.923879532511287f,
+        -0.38268343236509f, -0.923879532511287f, -0.923879532511287f, -0.38268343236509f, -0.923879532511287f, 0.38268343236509f, -0.38268343236509f, 0.923879532511287f,
+    };
+
+    // constants exactly as FastNoiseLite derives them (float arithmetic)
+    const float SQRT3 = 1.7320508075688772935274463415059f;
+    const float F2 = 0.5f * (SQRT3 - 1);
+    const float G2 = (3 - SQRT3) / 6;
+    const float CornerCScale = (float)(2 * (1 - 2 * G2) * (1 / G2 - 2));
+    const float CornerCBias = (float)(-2 * (1 - 2 * G2) * (1 - 2 * G2));
+    const float OutputScale = 99.83685446303647f;
+
+#if defined(__SSE2__)
+    // 32-bit lane multiply (wrapping), emulated when SSE4.1 (_mm_mullo_epi32) is unavailable
+    inline __m128i mulLo(__m128i a, __m128i b)
+    {
+#if defined(__SSE4_1__)
+        return _mm_mullo_epi32(a, b);
+#else
+        __m128i even = _mm_mul_epu32(a, b);
+        __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+    }
+
+    // FastFloor: truncate, minus one for negative inputs (integers included, as in FastNoiseLite)
+    inline __m128i fastFloor(__m128 f)
+    {
+        __m128i truncated = _mm_cvttps_epi32(f);
+        return _mm_add_epi32(truncated, _mm_castps_si128(_mm_cmplt_ps(f, _mm_setzero_ps())));
+    }
+
+    inline __m128 select(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    // FastNoiseLite::GradCoord, gradient table gathered lane by lane
+    inline __m128 gradCoord(__m128i seed, __m128i xPrimed, __m128i yPrimed, __m128 xd, __m128 yd)
+    {
+        __m128i hash = _mm_xor_si128(_mm_xor_si128(seed, xPrimed), yPrimed);
+        hash = mulLo(hash, _mm_set1_epi32(HashMultiplier));
+        hash = _mm_xor_si128(hash, _mm_srai_epi32(hash, 15));
+        hash = _mm_and_si128(hash, _mm_set1_epi32(127 << 1));
+
+        int idx0 = _mm_cvtsi128_si32(hash);
+        int idx1 = _mm_cvtsi128_si32(_mm_shuffle_epi32(hash, _MM_SHUFFLE(1, 1, 1, 1)));
+        int idx2 = _mm_cvtsi128_si32(_mm_shuffle_epi32(hash, _MM_SHUFFLE(2, 2, 2, 2)));
+        int idx3 = _mm_cvtsi128_si32(_mm_shuffle_epi32(hash, _MM_SHUFFLE(3, 3, 3, 3)));
+        // each (x, y) gradient pair is one 8 byte load, then transposed into x and y lanes
+        __m128 g01 = _mm_castpd_ps(_mm_unpacklo_pd(_mm_load_sd(reinterpret_cast<const double*>(Gradients2D + idx0)),
+                                                   _mm_load_sd(reinterpret_cast<const double*>(Gradients2D + idx1))));
+        __m128 g23 = _mm_castpd_ps(_mm_unpacklo_pd(_mm_load_sd(reinterpret_cast<const double*>(Gradients2D + idx2)),
+                                                   _mm_load_sd(reinterpret_cast<const double*>(Gradients2D + idx3))));
+        __m128 xg = _mm_shuffle_ps(g01, g23, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 yg = _mm_shuffle_ps(g01, g23, _MM_SHUFFLE(3, 1, 3, 1));
+        return _mm_add_ps(_mm_mul_ps(xd, xg), _mm_mul_ps(yd, yg));
+    }
+
+    // FastNoiseLite::SingleSimplex on already skewed coordinates
+    inline __m128 singleSimplex(__m128i seed, __m128 x, __m128 y)
+    {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 g2 = _mm_set1_ps(G2);
+
+        __m128i i = fastFloor(x);
+        __m128i j = fastFloor(y);
+        __m128 xi = _mm_sub_ps(x, _mm_cvtepi32_ps(i));
+        __m128 yi = _mm_sub_ps(y, _mm_cvtepi32_ps(j));
+
+        __m128 t = _mm_mul_ps(_mm_add_ps(xi, yi), g2);
+        __m128 x0 = _mm_sub_ps(xi, t);
+        __m128 y0 = _mm_sub_ps(yi, t);
+
+        i = mulLo(i, _mm_set1_epi32(PrimeX));
+        j = mulLo(j, _mm_set1_epi32(PrimeY));
+        __m128i iNext = _mm_add_epi32(i, _mm_set1_epi32(PrimeX));
+        __m128i jNext = _mm_add_epi32(j, _mm_set1_epi32(PrimeY));
+
+        __m128 a = _mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x0, x0)), _mm_mul_ps(y0, y0));
+        __m128 aa = _mm_mul_ps(a, a);
+        __m128 n0 = _mm_mul_ps(_mm_mul_ps(aa, aa), gradCoord(seed, i, j, x0, y0));
+        n0 = _mm_and_ps(_mm_cmpgt_ps(a, zero), n0);
+
+        __m128 c = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(CornerCScale), t), _mm_add_ps(_mm_set1_ps(CornerCBias), a));
+        __m128 x2 = _mm_add_ps(x0, _mm_set1_ps(2 * G2 - 1));
+        __m128 y2 = _mm_add_ps(y0, _mm_set1_ps(2 * G2 - 1));
+        __m128 cc = _mm_mul_ps(c, c);
+        __m128 n2 = _mm_mul_ps(_mm_mul_ps(cc, cc), gradCoord(seed, iNext, jNext, x2, y2));
+        n2 = _mm_and_ps(_mm_cmpgt_ps(c, zero), n2);
+
+        // middle corner depends on which triangle of the skewed cell the point lies in
+        __m128 upper = _mm_cmpgt_ps(y0, x0);
+        __m128i upperInt = _mm_castps_si128(upper);
+        __m128 x1 = _mm_add_ps(x0, select(upper, g2, _mm_set1_ps(G2 - 1)));
+        __m128 y1 = _mm_add_ps(y0, select(upper, _mm_set1_ps(G2 - 1), g2));
+        __m128i i1 = _mm_or_si128(_mm_and_si128(upperInt, i), _mm_andnot_si128(upperInt, iNext));
+        __m128i j1 = _mm_or_si128(_mm_and_si128(upperInt, jNext), _mm_andnot_si128(upperInt, j));
+        __m128 b = _mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x1, x1)), _mm_mul_ps(y1, y1));
+        __m128 bb = _mm_mul_ps(b, b);
+        __m128 n1 = _mm_mul_ps(_mm_mul_ps(bb, bb), gradCoord(seed, i1, j1, x1, y1));
+        n1 = _mm_and_ps(_mm_cmpgt_ps(b, zero), n1);
+
+        return _mm_mul_ps(_mm_add_ps(_mm_add_ps(n0, n1), n2), _mm_set1_ps(OutputScale));
+    }
+#endif
+}
+
+GridNoise::GridNoise()
+{
+    m_Scalar.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
+    calculateFractalBounding();
+}
+
+void GridNoise::setSeed(int seed)
+{
+    m_Seed = seed;
+    m_Scalar.SetSeed(seed);
+}
+
+void GridNoise::setFrequency(float frequency)
+{
+    m_Frequency = frequency;
+    m_Scalar.SetFrequency(frequency);
+}
+
+void GridNoise::setFractalType(FastNoiseLite::FractalType fractalType)
+{
+    if (fractalType != FastNoiseLite::FractalType_None && fractalType != FastNoiseLite::FractalType_FBm)
+        throw std::runtime_error("[Runtime Exception] GridNoise only supports FractalType_None and FractalType_FBm");
+    m_FractalType = fractalType;
+    m_Scalar.SetFractalType(fractalType);
+}
+
+void GridNoise::setFractalOctaves(int octaves)
+{
+    m_Octaves = octaves;
+    m_Scalar.SetFractalOctaves(octaves);
+    calculateFractalBounding();
+}
+
+void GridNoise::setFractalLacunarity(float lacunarity)
+{
+    m_Lacunarity = lacunarity;
+    m_Scalar.SetFractalLacunarity(lacunarity);
+}
+
+void GridNoise::setFractalGain(float gain)
+{
+    m_Gain = gain;
+    m_Scalar.SetFractalGain(gain);
+    calculateFractalBounding();
+}
+
+void GridNoise::setFractalWeightedStrength(float weightedStrength)
+{
+    m_WeightedStrength = weightedStrength;
+    m_Scalar.SetFractalWeightedStrength(weightedStrength);
+}
+
+float GridNoise::getNoise(float x, float y) const
+{
+    return m_Scalar.GetNoise(x, y);
+}
+
+void GridNoise::getNoiseTile(float x, float y, int width, int height, float* out, int spacing) const
+{
+#if defined(__SSE2__)
+    getNoiseTileSSE2(x, y, width, height, out, spacing);
+#else
+    getNoiseTileScalar(x, y, width, height, out, spacing);
+#endif
+}
+
+void GridNoise::calculateFractalBounding()
+{
+    // FastNoiseLite::CalculateFractalBounding
+    float gain = m_Gain < 0 ? -m_Gain : m_Gain;
+    float amp = gain;
+    float ampFractal = 1.0f;
+    for (int i = 1; i < m_Octaves; i++)
+    {
+        ampFractal += amp;
+        amp *= gain;
+    }
+    m_FractalBounding = 1 / ampFractal;
+}
+
+void GridNoise::getNoiseTileScalar(float x, float y, int width, int height, float* out, int spacing) const
+{
+    for (int j = 0; j < height; j++)
+        for (int i = 0; i < width; i++)
+            out[i + j * width] = m_Scalar.GetNoise(x + i * spacing, y + j * spacing);
+}
+
+#if defined(__SSE2__)
+void GridNoise::getNoiseTileSSE2(float x, float y, int width, int height, float* out, int spacing) const
+{
+    const __m128 frequency = _mm_set1_ps(m_Frequency);
+    const __m128 f2 = _mm_set1_ps(F2);
+    const __m128 lacunarity = _mm_set1_ps(m_Lacunarity);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 laneOffsets = _mm_setr_ps(0.0f, spacing, 2.0f * spacing, 3.0f * spacing);
+
+    for (int j = 0; j < height; j++)
+    {
+        for (int i = 0; i < width; i += 4)
+        {
+            // same inputs as GetNoise(x + i * spacing, y + j * spacing), then TransformNoiseCoordinate
+            // (frequency, OpenSimplex2 skew); integer offsets convert to float exactly
+            __m128 px = _mm_add_ps(_mm_set1_ps(x), _mm_add_ps(_mm_set1_ps(static_cast<float>(i * spacing)), laneOffsets));
+            __m128 py = _mm_set1_ps(y + j * spacing);
+            px = _mm_mul_ps(px, frequency);
+            py = _mm_mul_ps(py, frequency);
+            __m128 t = _mm_mul_ps(_mm_add_ps(px, py), f2);
+            px = _mm_add_ps(px, t);
+            py = _mm_add_ps(py, t);
+
+            __m128 noise;
+            if (m_FractalType == FastNoiseLite::FractalType_FBm)
+            {
+                // FastNoiseLite::GenFractalFBm
+                int seed = m_Seed;
+                __m128 sum = _mm_setzero_ps();
+                __m128 amp = _mm_set1_ps(m_FractalBounding);
+                for (int octave = 0; octave < m_Octaves; octave++)
+                {
+                    __m128 octaveNoise = singleSimplex(_mm_set1_epi32(seed++), px, py);
+                    sum = _mm_add_ps(sum, _mm_mul_ps(octaveNoise, amp));
+                    // amp *= Lerp(1, FastMin(noise + 1, 2) * 0.5f, weightedStrength)
+                    __m128 weight = _mm_mul_ps(_mm_min_ps(_mm_add_ps(octaveNoise, one), _mm_set1_ps(2.0f)),
+                                               _mm_set1_ps(0.5f));
+                    amp = _mm_mul_ps(amp, _mm_add_ps(one, _mm_mul_ps(_mm_set1_ps(m_WeightedStrength),
+                                                                     _mm_sub_ps(weight, one))));
+                    px = _mm_mul_ps(px, lacunarity);
+                    py = _mm_mul_ps(py, lacunarity);
+                    amp = _mm_mul_ps(amp, _mm_set1_ps(m_Gain));
+                }
+                noise = sum;
+            }
+            else
+                noise = singleSimplex(_mm_set1_epi32(m_Seed), px, py);
+
+            if (width - i >= 4)
+                _mm_storeu_ps(out + i + j * width, noise);
+            else
+            {
+                // partial last group of a row
+                alignas(16) float lanes[4];
+                _mm_store_ps(lanes, noise);
+                for (int lane = 0; lane < width - i; lane++)
+                    out[i + lane + j * width] = lanes[lane];
+            }
+        }
+    }
+}
+#endif
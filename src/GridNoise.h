@@ -0,0 +1,43 @@
+#pragma once
+
+#include <FastNoiseLite/FastNoiseLite.h>
+
+// batched 2D OpenSimplex2 noise: evaluates a whole tile of integer-spaced points per call, 4 lanes at a time (SSE2)
+// results are bit-identical to FastNoiseLite::GetNoise configured with the same settings, so seeds keep their terrain
+// supports the settings ChunkGenerator uses: OpenSimplex2, fractal type None or FBm
+class GridNoise {
+public:
+    GridNoise();
+
+    // mirror FastNoiseLite's setters (and defaults)
+    void setSeed(int seed);
+    void setFrequency(float frequency);
+    void setFractalType(FastNoiseLite::FractalType fractalType); // FractalType_None or FractalType_FBm
+    void setFractalOctaves(int octaves);
+    void setFractalLacunarity(float lacunarity);
+    void setFractalGain(float gain);
+    void setFractalWeightedStrength(float weightedStrength);
+
+    float getNoise(float x, float y) const;
+    // out[i + j * width] = noise(x + i * spacing, y + j * spacing) for i < width, j < height
+    void getNoiseTile(float x, float y, int width, int height, float* out, int spacing = 1) const;
+
+private:
+    int m_Seed = 1337;
+    float m_Frequency = 0.01f;
+    FastNoiseLite::FractalType m_FractalType = FastNoiseLite::FractalType_None;
+    int m_Octaves = 3;
+    float m_Lacunarity = 2.0f;
+    float m_Gain = 0.5f;
+    float m_WeightedStrength = 0.0f;
+    float m_FractalBounding = 1 / 1.75f;
+
+    // scalar path (and reference): FastNoiseLite configured identically
+    mutable FastNoiseLite m_Scalar;
+
+    void calculateFractalBounding();
+    void getNoiseTileScalar(float x, float y, int width, int height, float* out, int spacing) const;
+#if defined(__SSE2__)
+    void getNoiseTileSSE2(float x, float y, int width, int height, float* out, int spacing) const;
+#endif
+};
@@ -1,15 +1,20 @@
 // NOTE: might replace callbacks with more comprehensive InputSystem events
 // probably only necessary if things like inventory implemented
 
+#include <algorithm>
+
 #include "InputSystem.h"
 #include "Player.h"
 #include "BlockPool.h"
 #include "Components.h"
+#include "FrameBudget.h"
+#include "TimeOfDay.h"
 
 //InputSystem::InputSystem() : m_Registry(entt::m_Registry), window(NULL), camera(NULL)
 //{}
 
-InputSystem::InputSystem(entt::registry& registry, GLFWwindow* w, Camera* c) : m_Registry(registry), window(w), camera(c)
+InputSystem::InputSystem(entt::registry& registry, GLFWwindow* w, Camera* c, LightEngine& lightEngine)
+    : m_Registry(registry), m_LightEngine(lightEngine), window(w), camera(c)
 {}
 
 InputSystem::~InputSystem()
@@ -46,7 +51,7 @@ void InputSystem::assign_window_callbacks()
 
     auto pass_mouse_button_callback = [](GLFWwindow* w, int button, int action, int mods)
     {
-        static_cast<InputSystem*>(glfwGetWindowUserPointer(w))->processClick();
+        static_cast<InputSystem*>(glfwGetWindowUserPointer(w))->processClick(button, action);
     };
 
     glfwSetFramebufferSizeCallback(window, pass_frame_buffer_callback);
@@ -95,20 +100,63 @@ void InputSystem::processDebug() {
         glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
     if (glfwGetKey(window, GLFW_KEY_LEFT_SHIFT) == GLFW_RELEASE)
         glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+    // print last frame's streaming work (done / deferred) when F3 is pressed
+    bool budgetKeyDown = glfwGetKey(window, GLFW_KEY_F3) == GLFW_PRESS;
+    if (budgetKeyDown && not m_BudgetKeyWasDown)
+    {
+        const FrameBudgetComponent& budget = getFrameBudget(m_Registry);
+        std::cout << "commits " << budget.chunksCommitted << " (" << budget.commitsDeferred << " deferred), "
+                  << "meshes " << budget.chunksMeshed << " (" << budget.meshesDeferred << " deferred), "
+                  << "section uploads " << budget.sectionsUploaded << " (" << budget.sectionUploadsDeferred
+                  << " deferred)\n";
+    }
+    m_BudgetKeyWasDown = budgetKeyDown;
+
+    processBudgetKeys();
+
+    // hold T to run the day/night cycle 60x faster
+    getTimeOfDay(m_Registry).timeScale = (glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS) ? 60.0f : 1.0f;
+}
+
+// page up / page down double / halve every streaming budget, trading frame time for faster loading
+void InputSystem::processBudgetKeys() {
+    bool upKeyDown = glfwGetKey(window, GLFW_KEY_PAGE_UP) == GLFW_PRESS;
+    bool downKeyDown = glfwGetKey(window, GLFW_KEY_PAGE_DOWN) == GLFW_PRESS;
+    double scale = 1.0;
+    if (upKeyDown && not m_BudgetUpKeyWasDown)
+        scale = 2.0;
+    else if (downKeyDown && not m_BudgetDownKeyWasDown)
+        scale = 0.5;
+    m_BudgetUpKeyWasDown = upKeyDown;
+    m_BudgetDownKeyWasDown = downKeyDown;
+    if (scale == 1.0)
+        return;
+
+    // below a quarter millisecond a stage barely gets one chunk through, past 64 ms it is no longer a budget
+    FrameBudgetComponent& budget = getFrameBudget(m_Registry);
+    for (double* stageBudgetMs : {&budget.commitBudgetMs, &budget.meshBudgetMs, &budget.uploadBudgetMs})
+        *stageBudgetMs = std::clamp(*stageBudgetMs * scale, 0.25, 64.0);
+    std::cout << "budgets (ms): commit " << budget.commitBudgetMs << ", mesh " << budget.meshBudgetMs
+              << ", upload " << budget.uploadBudgetMs << "\n";
 }
 
-// if primary mouse button clicked, delete selected block
-void InputSystem::processClick() {
-    if ((glfwGetKey(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS))
-        std::cout << "pressed!!" << "\n";
-    if (glfwGetKey(window, GLFW_MOUSE_BUTTON_LEFT) != GLFW_PRESS)
+// primary mouse button deletes the selected block, secondary places a light source against it
+void InputSystem::processClick(int button, int action) {
+    if (action != GLFW_PRESS || (button != GLFW_MOUSE_BUTTON_LEFT && button != GLFW_MOUSE_BUTTON_RIGHT))
         return;
 
-    auto [isSelected, selectedBlockPos] = selectPlayerBlock(m_Registry);
+    auto [isSelected, selectedBlockPos, placeBlockPos] = selectPlayerBlock(m_Registry);
     if (not isSelected)
         return;
 
     entt::entity e_ChunkMap = m_Registry.view<ChunkMapComponent>().front();
     ChunkMapComponent& chunkMap = m_Registry.get<ChunkMapComponent>(e_ChunkMap);
-    chunkMap.setBlock(selectedBlockPos, AIR);
+    glm::ivec3 editPos = (button == GLFW_MOUSE_BUTTON_LEFT) ? selectedBlockPos : placeBlockPos;
+    if (button == GLFW_MOUSE_BUTTON_RIGHT
+        && (placeBlockPos == selectedBlockPos || chunkMap.blockAt(placeBlockPos)->typeOf() != AIR))
+        return; // nowhere to place (ray started inside the block)
+
+    chunkMap.setBlock(editPos, (button == GLFW_MOUSE_BUTTON_LEFT) ? AIR : GLOWSTONE);
+    m_LightEngine.updateBlockLight(editPos); // only touched chunks get remeshed
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Camera.h"
 #include "Block.h"
+#include "LightEngine.h"
 #include <GLFW/glfw3.h>
 #include <entt/entt.hpp>
 
@@ -10,7 +11,7 @@ class Camera;
 class InputSystem {
 public:
     InputSystem() = delete;
-    InputSystem(entt::registry& registry, GLFWwindow* w, Camera* c);
+    InputSystem(entt::registry& registry, GLFWwindow* w, Camera* c, LightEngine& lightEngine);
     ~InputSystem();
 
     void update(entt::registry& registry, double deltaTime);
@@ -20,8 +21,12 @@ public:
 
 private:
     entt::registry& m_Registry;
+    LightEngine& m_LightEngine;
     GLFWwindow* window;
     Camera* camera;
+    bool m_BudgetKeyWasDown = false;
+    bool m_BudgetUpKeyWasDown = false;
+    bool m_BudgetDownKeyWasDown = false;
 
     // OpenGL window callback functions
     void processKeyCallbacks(double deltaTime);
@@ -29,6 +34,7 @@ private:
 
     void processMovement(double deltaTime);
     void processDebug();
-    void processClick();
+    void processBudgetKeys();
+    void processClick(int button, int action);
 
 };
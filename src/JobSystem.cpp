@@ -0,0 +1,147 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+namespace {
+    // index of the pool worker running on this thread, -1 on threads outside the pool
+    thread_local int t_WorkerIdx = -1;
+    thread_local const void* t_WorkerPool = nullptr;
+}
+
+JobSystem::JobSystem(unsigned int workerCount)
+{
+    workerCount = std::max(1u, workerCount);
+    for (unsigned int i = 0; i < workerCount; i++)
+        m_Queues.push_back(std::make_unique<WorkerQueue>());
+    for (unsigned int i = 0; i < workerCount; i++)
+        m_Workers.emplace_back(&JobSystem::workerLoop, this, i);
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Running = false;
+    }
+    m_WakeCondition.notify_all();
+    for (std::thread& worker : m_Workers)
+        worker.join();
+}
+
+unsigned int JobSystem::defaultWorkerCount()
+{
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    return (hardwareThreads > 1) ? hardwareThreads - 1 : 1;
+}
+
+void JobSystem::submit(Job job, JobCounter* counter)
+{
+    if (counter)
+        counter->remaining.fetch_add(1, std::memory_order_relaxed);
+
+    // jobs spawned by a worker stay on its own deque (cache-warm), others are spread round-robin
+    int queueIdx = (t_WorkerPool == this) ? t_WorkerIdx
+                                          : static_cast<int>(m_NextQueue.fetch_add(1) % m_Queues.size());
+    {
+        std::lock_guard<std::mutex> lock(m_Queues[queueIdx]->mutex);
+        m_Queues[queueIdx]->tasks.push_back({std::move(job), counter});
+    }
+    m_QueuedTasks.fetch_add(1, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex); // pairs with the sleep predicate check
+    }
+    m_WakeCondition.notify_one();
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+    int ownQueue = (t_WorkerPool == this) ? t_WorkerIdx : -1;
+    // help out instead of blocking: the waiting thread becomes an extra worker for the batch,
+    // but only for its own batch so a short wait never picks up an unrelated long-running job
+    while (counter.remaining.load(std::memory_order_acquire) > 0)
+    {
+        if (not tryRunTask(ownQueue, &counter))
+            std::this_thread::yield(); // remaining jobs are in flight on other workers
+    }
+}
+
+void JobSystem::workerLoop(unsigned int workerIdx)
+{
+    t_WorkerIdx = static_cast<int>(workerIdx);
+    t_WorkerPool = this;
+
+    while (true)
+    {
+        if (tryRunTask(static_cast<int>(workerIdx)))
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_WakeCondition.wait(lock, [this]() {
+            return not m_Running || m_QueuedTasks.load(std::memory_order_acquire) > 0;
+        });
+        if (not m_Running)
+            return;
+    }
+}
+
+bool JobSystem::tryRunTask(int ownQueue, const JobCounter* onlyCounter)
+{
+    Task task;
+    if ((ownQueue >= 0 && popOwn(ownQueue, task, onlyCounter)) || steal(ownQueue, task, onlyCounter))
+    {
+        runTask(task);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::popOwn(int queueIdx, Task& task, const JobCounter* onlyCounter)
+{
+    WorkerQueue& queue = *m_Queues[queueIdx];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    // newest matching task, scanning from the back
+    for (auto it = queue.tasks.rbegin(); it != queue.tasks.rend(); ++it)
+    {
+        if (onlyCounter && it->counter != onlyCounter)
+            continue;
+        task = std::move(*it);
+        queue.tasks.erase(std::next(it).base());
+        m_QueuedTasks.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::steal(int thiefIdx, Task& task, const JobCounter* onlyCounter)
+{
+    // start at the neighbouring queue so thieves spread out instead of all hitting queue 0
+    int queueCount = static_cast<int>(m_Queues.size());
+    int start = (thiefIdx >= 0) ? thiefIdx + 1 : 0;
+    for (int i = 0; i < queueCount; i++)
+    {
+        int victim = (start + i) % queueCount;
+        if (victim == thiefIdx)
+            continue;
+        WorkerQueue& queue = *m_Queues[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        // oldest matching task, scanning from the front
+        auto it = queue.tasks.begin();
+        while (it != queue.tasks.end() && onlyCounter && it->counter != onlyCounter)
+            ++it;
+        if (it == queue.tasks.end())
+            continue;
+        task = std::move(*it);
+        queue.tasks.erase(it);
+        m_QueuedTasks.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void JobSystem::runTask(Task& task)
+{
+    task.job();
+    if (task.counter)
+        task.counter->remaining.fetch_sub(1, std::memory_order_release);
+}
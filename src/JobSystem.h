@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// counts outstanding jobs of one batch, wait() on it to block until the batch has finished
+struct JobCounter {
+    std::atomic<int> remaining {0};
+};
+
+// persistent fixed-size worker pool, one deque per worker
+// owners pop newest work from the back of their own deque, idle workers steal the oldest from the front of others
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    explicit JobSystem(unsigned int workerCount = defaultWorkerCount());
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void submit(Job job, JobCounter* counter = nullptr); // counter (optional) tracks completion
+    void wait(JobCounter& counter); // calling thread runs queued jobs of this counter until it reaches zero
+
+    unsigned int workerCount() const { return static_cast<unsigned int>(m_Workers.size()); }
+    // workers + the waiting caller together use every hardware thread
+    static unsigned int defaultWorkerCount();
+
+private:
+    struct Task {
+        Job job;
+        JobCounter* counter;
+    };
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_Queues;
+    std::vector<std::thread> m_Workers;
+    std::atomic<unsigned int> m_NextQueue {0}; // round-robin target for jobs submitted from outside the pool
+    std::atomic<int> m_QueuedTasks {0};
+    std::atomic<bool> m_Running {true};
+
+    // idle workers sleep here until new work is submitted
+    std::mutex m_SleepMutex;
+    std::condition_variable m_WakeCondition;
+
+    void workerLoop(unsigned int workerIdx);
+    // ownQueue < 0 for threads outside the pool, onlyCounter (optional) restricts which tasks may be taken
+    bool tryRunTask(int ownQueue, const JobCounter* onlyCounter = nullptr);
+    bool popOwn(int queueIdx, Task& task, const JobCounter* onlyCounter);
+    bool steal(int thiefIdx, Task& task, const JobCounter* onlyCounter);
+    void runTask(Task& task);
+};
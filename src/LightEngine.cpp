@@ -0,0 +1,231 @@
+#include "LightEngine.h"
+
+#include <algorithm>
+#include "Components.h"
+
+LightEngine::LightEngine(entt::registry& registry)
+    : m_Registry(registry)
+{}
+
+const std::vector<entt::entity>& LightEngine::stitchChunk(entt::entity e_Chunk)
+{
+    m_TouchedChunks.clear();
+    for (LightChannel channel : {SUNLIGHT, TORCHLIGHT})
+    {
+        for (Direction dir : {NORTH, SOUTH, WEST, EAST})
+            spreadAcrossBorder(e_Chunk, dir, channel);
+        propagate(channel);
+    }
+    return finishUpdate();
+}
+
+const std::vector<entt::entity>& LightEngine::updateBlockLight(const glm::ivec3& worldPos)
+{
+    ChunkMapComponent& chunkMap = m_Registry.get<ChunkMapComponent>(m_Registry.view<ChunkMapComponent>().front());
+    std::pair<int, int> chunkLoc = ChunkMapComponent::chunkOf(worldPos);
+    entt::entity e_Chunk = chunkMap[chunkLoc];
+    LightNode edited {e_Chunk, &m_Registry.get<ChunkComponent>(e_Chunk), worldPos.x - chunkLoc.first, worldPos.y,
+                      worldPos.z - chunkLoc.second};
+    m_TouchedChunks.clear();
+    // the block itself changed: its own mesh (and a neighbour's, for border blocks) is stale even if no light moves
+    touch(edited);
+
+    for (LightChannel channel : {SUNLIGHT, TORCHLIGHT})
+    {
+        // clear everything lit through the voxel, removeLight re-queues the brighter boundary it runs into
+        int oldLevel = lightOf(edited, channel);
+        if (oldLevel > 0)
+        {
+            setLight(edited, 0, channel);
+            m_RemovalQueue.push({edited, oldLevel});
+            removeLight(channel);
+        }
+
+        // a placed emitter lights its surroundings out to its own radius
+        int emission = (channel == TORCHLIGHT) ? blockOf(edited)->lightEmission() : 0;
+        if (emission > lightOf(edited, channel))
+        {
+            setLight(edited, emission, channel);
+            m_AddQueue.push(edited);
+        }
+
+        // open voxels take light from all six neighbours again (including sky access from above)
+        if (blockOf(edited)->isTransparent())
+        {
+            if (channel == SUNLIGHT && edited.y == CHUNK_HEIGHT - 1)
+            {
+                setLight(edited, 15, channel); // open to the sky
+                m_AddQueue.push(edited);
+            }
+            for (int dir = 0; dir < 6; dir++)
+            {
+                LightNode neighborNode = stepNode(edited, dir);
+                if (neighborNode.chunk != entt::null && lightOf(neighborNode, channel) > 1)
+                    m_AddQueue.push(neighborNode);
+            }
+        }
+        propagate(channel);
+    }
+    return finishUpdate();
+}
+
+void LightEngine::spreadAcrossBorder(entt::entity e_Chunk, Direction dir, LightChannel channel)
+{
+    ChunkComponent& chunkComp = m_Registry.get<ChunkComponent>(e_Chunk);
+    entt::entity e_Neighbor = chunkComp.neighborEntities[dir];
+    if (e_Neighbor == entt::null)
+        return; // pulls our border light itself once it loads
+    ChunkComponent& neighborComp = m_Registry.get<ChunkComponent>(e_Neighbor);
+
+    // border column of this chunk and the touching column of the neighbour
+    int borderX = (dir == WEST) ? 0 : CHUNK_WIDTH - 1;
+    int borderZ = (dir == SOUTH) ? 0 : CHUNK_WIDTH - 1;
+    bool alongX = (dir == NORTH || dir == SOUTH); // border runs along x
+    for (int y = 0; y < CHUNK_HEIGHT; y++)
+        for (int i = 0; i < CHUNK_WIDTH; i++)
+        {
+            int x = alongX ? i : borderX;
+            int z = alongX ? borderZ : i;
+            LightNode node {e_Chunk, &chunkComp, x, y, z};
+            LightNode neighborNode {e_Neighbor, &neighborComp, alongX ? x : CHUNK_WIDTH - 1 - x, y,
+                                    alongX ? CHUNK_WIDTH - 1 - z : z};
+
+            // light flows whichever way is brighter; the dimmer side only changes if it lets light through
+            int level = lightOf(node, channel);
+            int neighborLevel = lightOf(neighborNode, channel);
+            if (neighborLevel - 1 > level && blockOf(node)->isTransparent())
+            {
+                setLight(node, neighborLevel - 1, channel);
+                m_AddQueue.push(node);
+            }
+            else if (level - 1 > neighborLevel && blockOf(neighborNode)->isTransparent())
+            {
+                setLight(neighborNode, level - 1, channel);
+                m_AddQueue.push(neighborNode);
+            }
+        }
+}
+
+void LightEngine::removeLight(LightChannel channel)
+{
+    while (not m_RemovalQueue.empty())
+    {
+        RemovalNode cur = m_RemovalQueue.front();
+        m_RemovalQueue.pop();
+
+        for (int dir = 0; dir < 6; dir++)
+        {
+            LightNode neighborNode = stepNode(cur.node, dir);
+            if (neighborNode.chunk == entt::null)
+                continue;
+            int neighborLevel = lightOf(neighborNode, channel);
+            if (neighborLevel == 0)
+                continue;
+
+            if (neighborLevel <= passedLevel(cur.level, dir, channel))
+            {
+                // neighbour was (or could have been) lit through the removed voxel: clear it as well
+                setLight(neighborNode, 0, channel);
+                m_RemovalQueue.push({neighborNode, neighborLevel});
+                if (channel == TORCHLIGHT && blockOf(neighborNode)->lightEmission() > 0)
+                    m_Emitters.push_back(neighborNode); // its own light comes back once the removal is done
+            }
+            else if (neighborLevel >= cur.level)
+                m_AddQueue.push(neighborNode); // lit from elsewhere, floods the cleared area afterwards
+        }
+    }
+
+    // emitters caught by the removal relight what they lit themselves
+    for (const LightNode& emitter : m_Emitters)
+    {
+        int emission = blockOf(emitter)->lightEmission();
+        if (emission > lightOf(emitter, channel))
+        {
+            setLight(emitter, emission, channel);
+            m_AddQueue.push(emitter);
+        }
+    }
+    m_Emitters.clear();
+}
+
+void LightEngine::propagate(LightChannel channel)
+{
+    // BFS flood fill, same falloff as ChunkGenerator::updateLightMapBreadthFirst but free to cross chunk borders
+    while (not m_AddQueue.empty())
+    {
+        LightNode curNode = m_AddQueue.front();
+        m_AddQueue.pop();
+        int level = lightOf(curNode, channel);
+        if (level <= 1)
+            continue; // nothing left to spread
+
+        for (int dir = 0; dir < 6; dir++)
+        {
+            LightNode neighborNode = stepNode(curNode, dir);
+            if (neighborNode.chunk == entt::null)
+                continue; // outside the world or not loaded
+            int neighborLevel = passedLevel(level, dir, channel);
+            if (lightOf(neighborNode, channel) >= neighborLevel || not blockOf(neighborNode)->isTransparent())
+                continue; // already as bright, or opaque
+            setLight(neighborNode, neighborLevel, channel);
+            m_AddQueue.push(neighborNode);
+        }
+    }
+}
+
+LightEngine::LightNode LightEngine::stepNode(const LightNode& node, int dir) const
+{
+    LightNode next {node.chunk, node.chunkComp, node.x + deltaXByDir[dir], node.y + deltaYByDir[dir],
+                    node.z + deltaZByDir[dir]};
+    if (next.y < 0 || next.y >= CHUNK_HEIGHT)
+        next.chunk = entt::null; // outside the world
+    else if (next.x < 0 || next.x >= CHUNK_WIDTH || next.z < 0 || next.z >= CHUNK_WIDTH)
+    {
+        Direction borderDir = (next.x < 0) ? WEST : (next.x >= CHUNK_WIDTH) ? EAST : (next.z < 0) ? SOUTH : NORTH;
+        next.x = (next.x + CHUNK_WIDTH) % CHUNK_WIDTH;
+        next.z = (next.z + CHUNK_WIDTH) % CHUNK_WIDTH;
+        next.chunk = node.chunkComp->neighborEntities[borderDir];
+        if (next.chunk != entt::null)
+            next.chunkComp = &m_Registry.get<ChunkComponent>(next.chunk);
+    }
+    return next;
+}
+
+void LightEngine::setLight(const LightNode& node, int level, LightChannel channel)
+{
+    uint8_t& entry = node.chunkComp->lightMap[lightIndex(node.x, node.y, node.z)];
+    entry = (entry & ~(0xF << channel)) | (level << channel);
+    touch(node);
+}
+
+void LightEngine::touch(const LightNode& node)
+{
+    // a built mesh bakes in its own light and the light one voxel into each neighbour
+    // only the sections around the voxel's layer go stale, in a neighbour only the border part facing the voxel
+    if (m_TouchedChunks.empty() || m_TouchedChunks.back() != node.chunk) // BFS mostly stays in one chunk
+        m_TouchedChunks.push_back(node.chunk);
+    node.chunkComp->markSectionsDirty(node.y);
+    auto touchNeighbor = [this, &node](Direction dir, Direction dirTowardNode) {
+        entt::entity e_Neighbor = node.chunkComp->neighborEntities[dir];
+        if (e_Neighbor == entt::null)
+            return;
+        m_TouchedChunks.push_back(e_Neighbor);
+        if (MeshComponent* neighborMesh = m_Registry.try_get<MeshComponent>(e_Neighbor))
+            neighborMesh->staleParts |= borderMeshPart(dirTowardNode, node.y);
+    };
+    if (node.x == 0)
+        touchNeighbor(WEST, EAST);
+    else if (node.x == CHUNK_WIDTH - 1)
+        touchNeighbor(EAST, WEST);
+    if (node.z == 0)
+        touchNeighbor(SOUTH, NORTH);
+    else if (node.z == CHUNK_WIDTH - 1)
+        touchNeighbor(NORTH, SOUTH);
+}
+
+const std::vector<entt::entity>& LightEngine::finishUpdate()
+{
+    std::sort(m_TouchedChunks.begin(), m_TouchedChunks.end());
+    m_TouchedChunks.erase(std::unique(m_TouchedChunks.begin(), m_TouchedChunks.end()), m_TouchedChunks.end());
+    return m_TouchedChunks; // touch() already marked their sections dirty or border parts stale
+}
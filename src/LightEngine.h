@@ -0,0 +1,72 @@
+#pragma once
+
+#include <queue>
+#include <vector>
+#include <entt/entt.hpp>
+#include <glm/vec3.hpp>
+#include "Block.h"
+#include "Chunk.h"
+#include "ChunkComponent.h"
+
+// spreads light between loaded chunks, following ChunkComponent::neighborEntities across borders
+// chunks are lit locally when generated; the engine then only touches voxels whose light actually changes
+// light heading into a chunk that is not loaded yet is not stored: that chunk pulls it from its neighbours' borders
+// when it loads, which also covers chunks that are unloaded and later regenerated
+// main thread only, while no job reads the chunks' light maps
+class LightEngine {
+public:
+    explicit LightEngine(entt::registry& registry);
+
+    // exchanges light across the borders of a freshly lit chunk and its loaded neighbours
+    const std::vector<entt::entity>& stitchChunk(entt::entity e_Chunk);
+    // updates sunlight and torchlight after the block at worldPos changed (call after ChunkMapComponent::setBlock)
+    // removal BFS clears light that depended on the voxel, then light from the surrounding boundary floods back
+    // placing or breaking an emitter costs time proportional to the volume within its light radius
+    const std::vector<entt::entity>& updateBlockLight(const glm::ivec3& worldPos);
+
+    // both return the chunks whose meshes baked in a changed voxel, already queued for remeshing:
+    // the sections around each change marked dirty (dropping the chunk back to LIT), in a neighbour across the
+    // border only the border part facing the change marked stale
+
+private:
+    // bit offset of a light channel within lightMap entries
+    enum LightChannel { SUNLIGHT = 0, TORCHLIGHT = 4 };
+    struct LightNode {
+        entt::entity chunk;
+        ChunkComponent* chunkComp; // cached, components don't move while the engine runs
+        int x, y, z;
+    };
+    struct RemovalNode {
+        LightNode node;
+        int level; // light the voxel had before it was cleared
+    };
+
+    entt::registry& m_Registry;
+    std::queue<LightNode> m_AddQueue;
+    std::queue<RemovalNode> m_RemovalQueue;
+    std::vector<LightNode> m_Emitters; // emissive blocks darkened by the current removal
+    std::vector<entt::entity> m_TouchedChunks; // chunks with stale meshes from the current update
+
+    void spreadAcrossBorder(entt::entity e_Chunk, Direction dir, LightChannel channel);
+    void removeLight(LightChannel channel);
+    void propagate(LightChannel channel);
+    // neighbouring voxel in direction dir, possibly in the adjacent chunk; chunk is null outside the loaded world
+    LightNode stepNode(const LightNode& node, int dir) const;
+    // light a voxel at level passes on in direction dir (full sunlight travels straight down undimmed)
+    static int passedLevel(int level, int dir, LightChannel channel) {
+        return (channel == SUNLIGHT && level == 15 && deltaYByDir[dir] == -1) ? 15 : level - 1;
+    }
+    void setLight(const LightNode& node, int level, LightChannel channel);
+    void touch(const LightNode& node);
+    const std::vector<entt::entity>& finishUpdate();
+
+    static int lightIndex(int x, int y, int z) {
+        return x + (z * CHUNK_WIDTH) + (y * CHUNK_WIDTH * CHUNK_WIDTH);
+    }
+    static int lightOf(const LightNode& node, LightChannel channel) {
+        return (node.chunkComp->lightMap[lightIndex(node.x, node.y, node.z)] >> channel) & 0xF;
+    }
+    static const Block* blockOf(const LightNode& node) {
+        return node.chunkComp->blockAt(node.x, node.y, node.z);
+    }
+};
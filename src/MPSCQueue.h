@@ -0,0 +1,77 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+// lock-free multi-producer single-consumer queue (Vyukov's intrusive node queue)
+// any thread may push(), only one thread (the main thread) may tryPop()
+template <typename T>
+class MPSCQueue {
+public:
+    MPSCQueue()
+        : m_Head(&m_Stub), m_Tail(&m_Stub) {}
+    ~MPSCQueue() {
+        T discarded;
+        while (tryPop(discarded)) {}
+    }
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    void push(T value) {
+        pushNode(new Node(std::move(value)));
+    }
+
+    bool tryPop(T& out) {
+        Node* tail = m_Tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &m_Stub) // skip over stub node
+        {
+            if (next == nullptr)
+                return false;
+            m_Tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != nullptr)
+        {
+            m_Tail = next;
+            out = std::move(tail->value);
+            delete tail;
+            return true;
+        }
+        if (tail != m_Head.load(std::memory_order_acquire))
+            return false; // producer is mid-push, node becomes visible shortly
+
+        // tail is the last node: re-insert stub behind it so tail can be released
+        pushNode(&m_Stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next != nullptr)
+        {
+            m_Tail = next;
+            out = std::move(tail->value);
+            delete tail;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next {nullptr};
+        T value;
+        Node() = default;
+        explicit Node(T&& v) : value(std::move(v)) {}
+    };
+
+    std::atomic<Node*> m_Head; // producers push here
+    Node* m_Tail; // consumer pops here
+    Node m_Stub;
+
+    void pushNode(Node* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        // producers only contend on this exchange; linking the old head publishes the node to the consumer
+        Node* prev = m_Head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+};
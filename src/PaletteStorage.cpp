@@ -0,0 +1,242 @@
+#include "PaletteStorage.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    // bit i is set if field i of word (Bits wide) holds one of paletteIndices
+    // every field is compared at once, then the fields' result bits are packed together
+    template <int Bits>
+    uint64_t fieldsMatching(uint64_t word, const std::vector<uint64_t>& paletteIndices)
+    {
+        // lowest bit of every field, e.g. 0x5555... for 2 bit fields
+        constexpr uint64_t fieldLowBits = ~uint64_t{0} / ((uint64_t{1} << Bits) - 1);
+        uint64_t matching = 0;
+        for (uint64_t paletteIdx : paletteIndices)
+        {
+            uint64_t difference = word ^ (paletteIdx * fieldLowBits);
+            for (int shift = 1; shift < Bits; shift *= 2) // or every bit of a field into its lowest bit
+                difference |= difference >> shift;
+            matching |= ~difference & fieldLowBits;
+        }
+        // pack: bit i of the result sits at bit i * Bits, merge neighbouring groups until they are adjacent
+        for (int group = 1; Bits > 1 && group < 64 / Bits; group *= 2)
+        {
+            int spacing = Bits * group; // distance between the starts of two groups
+            uint64_t groupStarts = (2 * spacing >= 64) ? 1 : ~uint64_t{0} / ((uint64_t{1} << (2 * spacing)) - 1);
+            matching = (matching | (matching >> (spacing - group))) & (groupStarts * ((uint64_t{1} << (2 * group)) - 1));
+        }
+        return matching;
+    }
+
+    // the loops above unroll into constant shifts and masks for each index width
+    uint64_t fieldsMatching(uint64_t word, int bits, const std::vector<uint64_t>& paletteIndices)
+    {
+        if (paletteIndices.empty())
+            return 0;
+        switch (bits)
+        {
+            case 1: return fieldsMatching<1>(word, paletteIndices);
+            case 2: return fieldsMatching<2>(word, paletteIndices);
+            case 4: return fieldsMatching<4>(word, paletteIndices);
+            case 8: return fieldsMatching<8>(word, paletteIndices);
+            default: return fieldsMatching<16>(word, paletteIndices);
+        }
+    }
+}
+
+PaletteStorage::PaletteStorage(int size, BlockType fill)
+    : m_Size(size), m_Palette{fill}
+{}
+
+PaletteStorage PaletteStorage::fromRaw(int size, std::vector<BlockType> palette, int bitsPerIndex,
+                                       std::vector<uint64_t> data)
+{
+    bool validBits = bitsPerIndex == 0 || bitsPerIndex == 1 || bitsPerIndex == 2 || bitsPerIndex == 4
+                     || bitsPerIndex == 8 || bitsPerIndex == 16;
+    size_t wordCount = (static_cast<size_t>(size) * bitsPerIndex + 63) / 64;
+    if (not validBits || palette.empty() || data.size() != wordCount
+        || (bitsPerIndex > 0 && palette.size() > (size_t{1} << bitsPerIndex)))
+        throw std::runtime_error("[Runtime Exception] Inconsistent palette storage data");
+
+    PaletteStorage storage(size, palette[0]);
+    storage.m_Palette = std::move(palette);
+    storage.m_BitsPerIndex = bitsPerIndex;
+    storage.m_IndexMask = (bitsPerIndex == 0) ? 0 : (uint64_t{1} << bitsPerIndex) - 1;
+    storage.m_Data = std::move(data);
+    for (int i = 0; bitsPerIndex > 0 && i < size; i++)
+    {
+        int bitPos = i * bitsPerIndex;
+        if (((storage.m_Data[bitPos >> 6] >> (bitPos & 63)) & storage.m_IndexMask) >= storage.m_Palette.size())
+            throw std::runtime_error("[Runtime Exception] Palette index out of range");
+    }
+    return storage;
+}
+
+void PaletteStorage::matchMask(const std::vector<bool>& paletteMatches, uint16_t* mask) const
+{
+    const int rowBits = 16;
+    if (m_BitsPerIndex == 0)
+    {
+        std::fill(mask, mask + m_Size / rowBits, paletteMatches[0] ? 0xFFFF : 0);
+        return;
+    }
+
+    std::vector<uint64_t> matchingIndices;
+    for (size_t paletteIdx = 0; paletteIdx < m_Palette.size(); paletteIdx++)
+        if (paletteMatches[paletteIdx])
+            matchingIndices.push_back(paletteIdx);
+
+    // a word covers several mask rows (bits <= 4) or part of one (bits 8 and 16)
+    int indicesPerWord = 64 / m_BitsPerIndex;
+    for (int firstIdx = 0; firstIdx < m_Size; firstIdx += indicesPerWord)
+    {
+        uint64_t matching = fieldsMatching(m_Data[firstIdx / indicesPerWord], m_BitsPerIndex, matchingIndices);
+        if (indicesPerWord >= rowBits)
+        {
+            for (int idx = firstIdx; idx < firstIdx + indicesPerWord; idx += rowBits)
+                mask[idx / rowBits] = static_cast<uint16_t>(matching >> (idx - firstIdx));
+        }
+        else
+        {
+            uint16_t& row = mask[firstIdx / rowBits];
+            int bit = firstIdx % rowBits;
+            row = static_cast<uint16_t>(((bit == 0) ? 0 : row) | (matching << bit));
+        }
+    }
+}
+
+void PaletteStorage::unpack(BlockType* out) const
+{
+    if (m_BitsPerIndex == 0)
+    {
+        std::fill(out, out + m_Size, m_Palette[0]);
+        return;
+    }
+    // locals, stores through out could otherwise alias the members and force reloads
+    const BlockType* palette = m_Palette.data();
+    const int bitsPerIndex = m_BitsPerIndex;
+    const uint64_t indexMask = m_IndexMask;
+    const int indicesPerWord = 64 / bitsPerIndex;
+    for (int firstIdx = 0; firstIdx < m_Size; firstIdx += indicesPerWord)
+    {
+        uint64_t word = m_Data[firstIdx / indicesPerWord];
+        for (int idx = firstIdx; idx < firstIdx + indicesPerWord; idx++, word >>= bitsPerIndex)
+            out[idx] = palette[word & indexMask];
+    }
+}
+
+void PaletteStorage::set(int index, BlockType type)
+{
+    if (get(index) == type) // avoid growing palette for no-op writes
+        return;
+
+    int paletteIdx = paletteIndexOf(type);
+    int bitPos = index * m_BitsPerIndex;
+    uint64_t& word = m_Data[bitPos >> 6];
+    word = (word & ~(m_IndexMask << (bitPos & 63))) | (static_cast<uint64_t>(paletteIdx) << (bitPos & 63));
+}
+
+void PaletteStorage::fill(BlockType type)
+{
+    m_Palette.assign(1, type);
+    m_Data.clear();
+    m_Data.shrink_to_fit();
+    m_BitsPerIndex = 0;
+    m_IndexMask = 0;
+}
+
+void PaletteStorage::compact()
+{
+    if (m_BitsPerIndex == 0)
+        return;
+
+    // count uses of each palette entry
+    std::vector<int> useCount(m_Palette.size(), 0);
+    for (int i = 0; i < m_Size; i++)
+    {
+        int bitPos = i * m_BitsPerIndex;
+        useCount[(m_Data[bitPos >> 6] >> (bitPos & 63)) & m_IndexMask]++;
+    }
+
+    // remap surviving entries to a dense palette
+    std::vector<BlockType> palette;
+    std::vector<uint64_t> remap(m_Palette.size(), 0);
+    for (size_t i = 0; i < m_Palette.size(); i++)
+        if (useCount[i] > 0)
+        {
+            remap[i] = palette.size();
+            palette.push_back(m_Palette[i]);
+        }
+
+    if (palette.size() == 1)
+    {
+        fill(palette[0]);
+        return;
+    }
+
+    int bits = 1;
+    while ((size_t{1} << bits) < palette.size())
+        bits *= 2;
+    if (palette.size() == m_Palette.size() && bits == m_BitsPerIndex)
+        return; // nothing to reclaim
+
+    std::vector<uint64_t> data((static_cast<size_t>(m_Size) * bits + 63) / 64, 0);
+    for (int i = 0; i < m_Size; i++)
+    {
+        int oldPos = i * m_BitsPerIndex;
+        uint64_t idx = remap[(m_Data[oldPos >> 6] >> (oldPos & 63)) & m_IndexMask];
+        int newPos = i * bits;
+        data[newPos >> 6] |= idx << (newPos & 63);
+    }
+
+    m_Palette = std::move(palette);
+    m_Data = std::move(data);
+    m_BitsPerIndex = bits;
+    m_IndexMask = (uint64_t{1} << bits) - 1;
+}
+
+bool PaletteStorage::contains(BlockType type) const
+{
+    return std::find(m_Palette.begin(), m_Palette.end(), type) != m_Palette.end();
+}
+
+size_t PaletteStorage::memoryUsage() const
+{
+    return sizeof(PaletteStorage) + m_Palette.capacity() * sizeof(BlockType) + m_Data.capacity() * sizeof(uint64_t);
+}
+
+int PaletteStorage::paletteIndexOf(BlockType type)
+{
+    // palettes stay tiny (a chunk rarely holds more than a handful of types), linear search is fastest
+    for (size_t i = 0; i < m_Palette.size(); i++)
+        if (m_Palette[i] == type)
+            return static_cast<int>(i);
+
+    m_Palette.push_back(type);
+    if (m_Palette.size() > (size_t{1} << m_BitsPerIndex)) // palette outgrew index width
+    {
+        int bits = std::max(1, m_BitsPerIndex * 2); // 1, 2, 4, 8, 16
+        resize(bits);
+    }
+    return static_cast<int>(m_Palette.size()) - 1;
+}
+
+void PaletteStorage::resize(int bitsPerIndex)
+{
+    std::vector<uint64_t> data((static_cast<size_t>(m_Size) * bitsPerIndex + 63) / 64, 0);
+    uint64_t mask = (uint64_t{1} << bitsPerIndex) - 1;
+
+    if (m_BitsPerIndex != 0) // copy over existing indices (all zero when previously uniform)
+        for (int i = 0; i < m_Size; i++)
+        {
+            int oldPos = i * m_BitsPerIndex;
+            uint64_t idx = (m_Data[oldPos >> 6] >> (oldPos & 63)) & m_IndexMask;
+            int newPos = i * bitsPerIndex;
+            data[newPos >> 6] |= idx << (newPos & 63);
+        }
+
+    m_Data = std::move(data);
+    m_BitsPerIndex = bitsPerIndex;
+    m_IndexMask = mask;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Block.h"
+
+// compact block storage: small palette of distinct BlockTypes + bit-packed palette indices
+// index width starts at 0 bits (single type, no index array) and widens only when palette outgrows it
+class PaletteStorage {
+public:
+    explicit PaletteStorage(int size, BlockType fill = AIR);
+
+    BlockType get(int index) const {
+        if (m_BitsPerIndex == 0)
+            return m_Palette[0];
+        // widths divide 64 evenly, so an entry never straddles two words
+        int bitPos = index * m_BitsPerIndex;
+        uint64_t word = m_Data[bitPos >> 6];
+        return m_Palette[(word >> (bitPos & 63)) & m_IndexMask];
+    }
+    void set(int index, BlockType type);
+    void fill(BlockType type); // reset every entry to type, drops index array
+    void compact(); // drop unused palette entries and narrow index width (uniform storage loses its array)
+
+    int size() const { return m_Size; }
+    int paletteSize() const { return static_cast<int>(m_Palette.size()); }
+    int bitsPerIndex() const { return m_BitsPerIndex; }
+    bool isUniform() const { return m_BitsPerIndex == 0; } // every entry has the same type
+    bool contains(BlockType type) const;
+    // sets bit i % 16 of mask[i / 16] for every entry whose palette entry is flagged in paletteMatches
+    // compares whole index words at once, size() must be a multiple of 16
+    void matchMask(const std::vector<bool>& paletteMatches, uint16_t* mask) const;
+    void unpack(BlockType* out) const; // writes all size() entries, a word of indices at a time
+    const std::vector<BlockType>& palette() const { return m_Palette; }
+    const std::vector<uint64_t>& data() const { return m_Data; } // packed indices, bitsPerIndex() each
+    // rebuilds a storage from its palette(), bitsPerIndex() and data() (e.g. read back from disk), throws if inconsistent
+    static PaletteStorage fromRaw(int size, std::vector<BlockType> palette, int bitsPerIndex, std::vector<uint64_t> data);
+    size_t memoryUsage() const; // heap + object bytes, used for benchmarking
+
+private:
+    int m_Size;
+    int m_BitsPerIndex = 0; // one of 0, 1, 2, 4, 8, 16
+    uint64_t m_IndexMask = 0;
+    std::vector<BlockType> m_Palette; // m_Palette[0] is the fill type
+    std::vector<uint64_t> m_Data; // packed indices, empty while bitsPerIndex == 0
+
+    int paletteIndexOf(BlockType type);
+    void resize(int bitsPerIndex); // repack existing indices at new width
+};
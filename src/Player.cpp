@@ -3,7 +3,6 @@
 #include "entt/entt.hpp"
 #include "Components.h"
 #include "Player.h"
-#include "BlockPool.h"
 
 glm::vec3 getPlayerPos(const entt::registry& registry)
 {
@@ -19,7 +18,7 @@ glm::vec3 getPlayerCameraDir(const entt::registry& registry)
         return registry.get<CameraComponent>(e_Player).camera->Front;
 }
 
-std::tuple<const bool, const glm::ivec3> selectPlayerBlock(entt::registry& registry)
+std::tuple<const bool, const glm::ivec3, const glm::ivec3> selectPlayerBlock(entt::registry& registry)
 {
     // initialization phase
     glm::vec3 origin = getPlayerPos(registry);
@@ -34,11 +33,11 @@ std::tuple<const bool, const glm::ivec3> selectPlayerBlock(entt::registry& regis
      * t.x = (uNext.x - u.x)/v.x
      */
     glm::vec3 tMax ((step.x == 0) ? std::numeric_limits<float>::infinity() :
-                    (step.x == 1) ? (ceil(origin.x) - origin.x)/dir.x : (origin.x - floor(origin.x))/dir.x,
+                    (step.x == 1) ? (ceil(origin.x) - origin.x)/dir.x : (origin.x - floor(origin.x))/-dir.x,
                     (step.y == 0) ? std::numeric_limits<float>::infinity() :
-                    (step.y == 1) ? (ceil(origin.y) - origin.y)/dir.y : (origin.y - floor(origin.y))/dir.y,
+                    (step.y == 1) ? (ceil(origin.y) - origin.y)/dir.y : (origin.y - floor(origin.y))/-dir.y,
                     (step.z == 0) ? std::numeric_limits<float>::infinity() :
-                    (step.z == 1) ? (ceil(origin.z) - origin.z)/dir.z : (origin.z - floor(origin.z))/dir.z);
+                    (step.z == 1) ? (ceil(origin.z) - origin.z)/dir.z : (origin.z - floor(origin.z))/-dir.z);
     // find t value for ray to cross any full 1-length voxel (for each dir)
     /*
      * t*v.x = stepX
@@ -54,44 +53,60 @@ std::tuple<const bool, const glm::ivec3> selectPlayerBlock(entt::registry& regis
     auto chunkMapView = registry.view<ChunkMapComponent>();
     entt::entity e_ChunkMap = chunkMapView.front();
     ChunkMapComponent& chunkMap = registry.get<ChunkMapComponent>(e_ChunkMap);
-    // retrieve blockpool
-    const auto& blockPool = BlockPool::getPoolInstance();
 
-    // TODO: eventually change to first target outside of origin? unsure what is desired mechanic
-    // TODO: player range
-    // manhattan vs euc
-    std::pair<int, int> curChunk = chunkMap.chunkOf(origin);
-    if (!chunkMap.isLoaded(curChunk))
-        return {false, {-1, -1, -1}};
-    const Block* curBlock = chunkMap.blockAt(origin);
-
-    while (curBlock == blockPool.getBlockPtr(AIR))
-    {
+    // steps ray into the next voxel along whichever axis boundary is crossed first
+    glm::ivec3 voxel(glm::floor(origin));
+    glm::ivec3 prevVoxel = voxel; // where a block placed against the hit face goes
+    auto advance = [&]() {
+        prevVoxel = voxel;
         if (tMax.x <= tMax.y && tMax.x <= tMax.z)
         {
-            origin.x += step.x;
+            voxel.x += step.x;
             tMax.x += tDelta.x;
         } else if (tMax.y <= tMax.x && tMax.y <= tMax.z)
         {
-            origin.y += step.y;
+            voxel.y += step.y;
             tMax.y += tDelta.y;
         } else
         { // tMax.z is minimum
-            origin.z += step.z;
+            voxel.z += step.z;
             tMax.z += tDelta.z;
-            if (origin.z < 0 || origin.z >= CHUNK_HEIGHT)
-                return {false, {-1, -1, -1}};
         }
+    };
 
-        if (chunkMap.chunkOf(origin) != curChunk) {
-            curChunk = chunkMap.chunkOf(origin);
+    // TODO: eventually change to first target outside of origin? unsure what is desired mechanic
+    // TODO: player range
+    // manhattan vs euc
+    std::pair<int, int> curChunk = chunkMap.chunkOf(voxel);
+    if (!chunkMap.isLoaded(curChunk))
+        return {false, {-1, -1, -1}, {-1, -1, -1}};
+    const ChunkComponent* chunkComp = &registry.get<ChunkComponent>(chunkMap[curChunk]);
+
+    while (true)
+    {
+        if (voxel.y < 0 || voxel.y >= CHUNK_HEIGHT)
+            return {false, {-1, -1, -1}, {-1, -1, -1}};
+
+        const ChunkSection& section = chunkComp->sectionAt(voxel.y / SECTION_HEIGHT);
+        if (section.isEmpty())
+        {
+            // nothing to hit in an all-air section: march through it without any block lookups
+            int sectionIdx = voxel.y / SECTION_HEIGHT;
+            while (chunkMap.chunkOf(voxel) == curChunk && voxel.y >= 0 && voxel.y / SECTION_HEIGHT == sectionIdx)
+                advance();
+        }
+        else if (section.typeAt(voxel.x - curChunk.first, voxel.y % SECTION_HEIGHT, voxel.z - curChunk.second) != AIR)
+            return {true, voxel, prevVoxel};
+        else
+            advance();
+
+        if (chunkMap.chunkOf(voxel) != curChunk) {
+            curChunk = chunkMap.chunkOf(voxel);
             if (!chunkMap.isLoaded(curChunk))
-                return {false, {-1, -1, -1}};
+                return {false, {-1, -1, -1}, {-1, -1, -1}};
+            chunkComp = &registry.get<ChunkComponent>(chunkMap[curChunk]);
         }
-        curBlock = chunkMap.blockAt(origin);
     }
-
-    return {true, origin};
 }
 
 int sgn(float x)
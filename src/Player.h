@@ -5,6 +5,7 @@ glm::vec3 getPlayerPos(const entt::registry& registry);
 
 glm::vec3 getPlayerCameraDir(const entt::registry& registry);
 
-std::tuple<const bool, const glm::ivec3> selectPlayerBlock(entt::registry& registry);
+// hit flag, first solid voxel along the view ray, and the voxel the ray passed through just before it
+std::tuple<const bool, const glm::ivec3, const glm::ivec3> selectPlayerBlock(entt::registry& registry);
 
 int sgn(float x);
@@ -1,7 +1,11 @@
 #include "RenderSystem.h"
 #include "Debug.h"
+#include "TimeOfDay.h"
 
+#include <algorithm>
+#include <bit>
 #include <iostream>
+#include <vector>
 #include <glad/glad.h>
 
 
@@ -22,19 +26,22 @@ RenderSystem::RenderSystem(std::shared_ptr<Camera> cam)
 
     // create vertex array object for rendering blocks in chunk
     GLCall(glGenVertexArrays(1, &blockVAO));
+    GLCall(glGenBuffers(1, &quadEBO));
+    reserveQuadIndices(INITIAL_QUAD_CAPACITY);
 }
 
 RenderSystem::~RenderSystem()
 {
     // de-allocate all OpenGL resources
     GLCall(glDeleteVertexArrays(1, &blockVAO));
+    GLCall(glDeleteBuffers(1, &quadEBO));
 
     glfwTerminate();
 }
 
 void RenderSystem::update(entt::registry& registry)
 {
-    clear_buffers();
+    clear_buffers(skyColor(getTimeOfDay(registry)));
 
     renderChunks(registry);
 
@@ -56,22 +63,38 @@ void RenderSystem::renderChunks(entt::registry& registry)
     // pass transformation matrices to the shader
     textureArrayShader->SetUniformMat4f("projection", projection);
     textureArrayShader->SetUniformMat4f("view", view);
+    // day/night only changes this uniform, no chunk is relit or remeshed
+    textureArrayShader->SetUniform1f("skyBrightness", skyBrightness(getTimeOfDay(registry)));
+
+    // VBO uploads share one budget per frame, meshes over budget keep drawing their previous upload
+    FrameBudgetComponent& budget = getFrameBudget(registry);
+    BudgetTimer uploadTimer(budget.uploadBudgetMs);
+    budget.sectionsUploaded = 0;
+    budget.sectionUploadsDeferred = 0;
 
     // later when multiple mesh types:
     // master renderer iterates through MeshComp view, feeds chunks to renderChunk, water to renderWater, etc.
-    auto meshView = registry.view<MeshComponent>();
+    auto meshView = registry.view<MeshComponent, ChunkComponent, PositionComponent>();
     for (const entt::entity& meshEntity : meshView)
     {
         MeshComponent& meshComp = meshView.get<MeshComponent>(meshEntity);
-
-//        if (not meshComp.initialized) {
-//            continue;
-//            GLCall(glBufferData(GL_ARRAY_BUFFER, meshComp.chunkVertices.size() * sizeof(texArrayVertex),
-//                                &meshComp.chunkVertices[0], GL_STATIC_DRAW));
-//        }
-
-        bindBuffer(meshComp); // bind VBO, send updated data to GPU if necessary
-        GLCall(glDrawArrays(GL_TRIANGLES, 0, meshComp.chunkVertices.size())); // draw call
+        ChunkComponent& chunkComp = meshView.get<ChunkComponent>(meshEntity);
+        const glm::vec3& chunkOrigin = meshView.get<PositionComponent>(meshEntity).pos;
+
+        // mesh vertices are chunk-local
+        textureArrayShader->SetUniform3f("chunkOrigin", chunkOrigin.x, chunkOrigin.y, chunkOrigin.z);
+
+        uploadSections(meshComp, chunkComp, budget, uploadTimer); // send remeshed sections to the GPU if necessary
+        for (int sectionIdx = 0; sectionIdx < CHUNK_SECTIONS; sectionIdx++)
+        {
+            if (meshComp.uploadedVertexCounts[sectionIdx] == 0)
+                continue; // all air, all solid or not uploaded yet
+            GLCall(glBindBuffer(GL_ARRAY_BUFFER, meshComp.sectionVBOs[sectionIdx]));
+            setBlockVAO();
+            GLsizei indexCount = static_cast<GLsizei>(meshComp.uploadedVertexCounts[sectionIdx] / VERTICES_PER_QUAD
+                                                      * INDICES_PER_QUAD);
+            GLCall(glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, (void*)0)); // draw call
+        }
     }
 
     // unbind, don't want persistent side effect
@@ -79,16 +102,36 @@ void RenderSystem::renderChunks(entt::registry& registry)
     textureArrayShader->Unbind();
 }
 
-void RenderSystem::bindBuffer(MeshComponent& meshComponent)
+void RenderSystem::uploadSections(MeshComponent& meshComponent, ChunkComponent& chunkComponent,
+                                  FrameBudgetComponent& budget, const BudgetTimer& uploadTimer)
 {
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, meshComponent.blockVBO)); // bind VBO
-    if (meshComponent.mustUpdateBuffer) // only send new data to GPU if necessary
+    // only send new data to GPU if necessary, first upload of a frame always goes through
+    bool mustUpdateBuffer = chunkComponent.status() == ChunkStatus::MESHED;
+    if (mustUpdateBuffer && budget.sectionsUploaded > 0 && uploadTimer.exhausted())
+        budget.sectionUploadsDeferred += std::popcount(meshComponent.unuploadedSections);
+    else if (mustUpdateBuffer)
     {
-        GLCall(glBufferData(GL_ARRAY_BUFFER, meshComponent.chunkVertices.size() * sizeof(texArrayVertex),
-                     &meshComponent.chunkVertices[0], GL_STATIC_DRAW));
-        meshComponent.mustUpdateBuffer = false; // note that buffer doesn't need updating until changed
+        // only the sections remeshed since their last upload, an edit usually touches one
+        for (int sectionIdx = 0; sectionIdx < CHUNK_SECTIONS; sectionIdx++)
+        {
+            if (not (meshComponent.unuploadedSections & (1 << sectionIdx)))
+                continue;
+            unsigned int& vbo = meshComponent.sectionVBOs[sectionIdx];
+            if (vbo == 0) // chunk data is created without a GL context, VBO is made on first use
+            {
+                GLCall(glGenBuffers(1, &vbo));
+            }
+            const std::vector<texArrayVertex>& vertices = meshComponent.sectionVertices[sectionIdx];
+            GLCall(glBindBuffer(GL_ARRAY_BUFFER, vbo));
+            GLCall(glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(texArrayVertex), vertices.data(),
+                                GL_STATIC_DRAW));
+            meshComponent.uploadedVertexCounts[sectionIdx] = vertices.size();
+            reserveQuadIndices(vertices.size() / VERTICES_PER_QUAD);
+            budget.sectionsUploaded++;
+        }
+        meshComponent.unuploadedSections = 0;
+        chunkComponent.setStatus(ChunkStatus::UPLOADED); // buffers don't need updating until remeshed
     }
-    setBlockVAO();
 }
 
 void RenderSystem::setBlockVAO()
@@ -97,18 +140,31 @@ void RenderSystem::setBlockVAO()
 //    GLCall(glGenVertexArrays(1, &blockVAO));
     GLCall(glBindVertexArray(blockVAO));
 
-    // position attribute (3 GLfloats)
-    GLCall(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(texArrayVertex), (void*)0));
+    // packed vertex (2 GLuints), integer attributes so the shader can unpack the bits
+    // position + u texture coord + face direction
+    GLCall(glVertexAttribIPointer(0, 1, GL_UNSIGNED_INT, sizeof(texArrayVertex), (void*)offsetof(texArrayVertex, positionU)));
     GLCall(glEnableVertexAttribArray(0));
 
-    // texture coord attribute (3 GLfloats)
-    // do we need to specify last as int instead of float?
-    GLCall(glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(texArrayVertex), (void*)offsetof(texArrayVertex, uTexCoord)));
+    // v texture coord + texture array layer + lighting (sunlight | torchlight << 4)
+    GLCall(glVertexAttribIPointer(1, 1, GL_UNSIGNED_INT, sizeof(texArrayVertex), (void*)offsetof(texArrayVertex, vLayerLight)));
     GLCall(glEnableVertexAttribArray(1));
+}
 
-    // lighting attribute (1 GLubyte)
-    GLCall(glVertexAttribPointer(2, 1, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(texArrayVertex), (void*)offsetof(texArrayVertex, lightLevel)));
-    GLCall(glEnableVertexAttribArray(2));
+void RenderSystem::reserveQuadIndices(size_t quadCount)
+{
+    if (quadCount <= quadIndexCapacity)
+        return;
+    quadIndexCapacity = std::max(quadCount, 2 * quadIndexCapacity);
+
+    std::vector<GLuint> indices(quadIndexCapacity * INDICES_PER_QUAD);
+    for (size_t quad = 0; quad < quadIndexCapacity; quad++)
+        for (int i = 0; i < INDICES_PER_QUAD; i++)
+            indices[quad * INDICES_PER_QUAD + i] = static_cast<GLuint>(quad * VERTICES_PER_QUAD) + QUAD_INDEX_PATTERN[i];
+
+    // the element buffer binding is part of the VAO's state, every chunk draw picks it up
+    GLCall(glBindVertexArray(blockVAO));
+    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEBO));
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW));
 }
 
 void RenderSystem::createWindow()
@@ -161,7 +217,7 @@ void RenderSystem::createWindow()
     glEnable(GL_DEPTH_TEST);
 }
 
-void RenderSystem::clear_buffers() {
-    glClearColor(0.604f, 0.796f, 1.0f, 1.0f);
+void RenderSystem::clear_buffers(const glm::vec3& skyColor) {
+    glClearColor(skyColor.r, skyColor.g, skyColor.b, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); // also clear the depth buffer now!
 }
\ No newline at end of file
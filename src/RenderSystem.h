@@ -7,6 +7,7 @@
 #include "Texture.h"
 #include "Shader.h"
 #include "Components.h"
+#include "FrameBudget.h"
 
 class Camera;
 
@@ -28,17 +29,24 @@ private:
 
     void renderChunks(entt::registry& registry);
     void setBlockVAO();
-    void bindBuffer(MeshComponent& meshComponent);
+    // grows the shared quad index buffer to cover at least quadCount quads
+    void reserveQuadIndices(size_t quadCount);
+    // re-uploads the chunk's sections that were remeshed since their last upload
+    void uploadSections(MeshComponent& meshComponent, ChunkComponent& chunkComponent, FrameBudgetComponent& budget,
+                        const BudgetTimer& uploadTimer);
 
     void createWindow();
 
-    static void clear_buffers();
+    static void clear_buffers(const glm::vec3& skyColor);
 
     // settings and constants
     const unsigned int SCR_WIDTH = 800;
     const unsigned int SCR_HEIGHT = 600;
 
     unsigned int blockVAO;
+    unsigned int quadEBO; // QUAD_INDEX_PATTERN repeated, shared by every chunk mesh and bound in blockVAO
+    size_t quadIndexCapacity = 0; // quads quadEBO covers
+    const size_t INITIAL_QUAD_CAPACITY = 16384;
 
 };
 
@@ -16,6 +16,7 @@ public:
 
     void SetUniform1i(const std::string& name, int value);
     void SetUniform1f(const std::string& name, float value);
+    void SetUniform3f(const std::string& name, float f0, float f1, float f2);
     void SetUniform4f(const std::string& name, float f0, float f1, float f2, float f3);
     void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
 private:
@@ -0,0 +1,73 @@
+#include "TerrainRegionCache.h"
+
+#include <algorithm>
+
+#include "ChunkKey.h"
+
+TerrainRegionCache::TerrainRegionCache(size_t maxRegions, ColumnGenerator generator)
+    : m_MaxRegions(std::max<size_t>(1, maxRegions)), m_Generator(std::move(generator))
+{}
+
+TerrainColumns TerrainRegionCache::columnsOf(const glm::vec3& chunkPos)
+{
+    int chunkX = floorDiv(static_cast<int>(chunkPos.x), CHUNK_WIDTH);
+    int chunkZ = floorDiv(static_cast<int>(chunkPos.z), CHUNK_WIDTH);
+    int regionX = floorDiv(chunkX, REGION_CHUNKS);
+    int regionZ = floorDiv(chunkZ, REGION_CHUNKS);
+    std::shared_ptr<Region> region = acquireRegion(regionX, regionZ);
+
+    int tileIdx = (chunkX - regionX * REGION_CHUNKS) + (chunkZ - regionZ * REGION_CHUNKS) * REGION_CHUNKS;
+    bool generated = false;
+    // concurrent requests for the same chunk wait here for the first one instead of generating twice
+    std::call_once(region->filled[tileIdx], [&]() {
+        auto columns = std::make_unique<TerrainColumns>();
+        m_Generator(chunkPos, *columns);
+        region->tiles[tileIdx] = std::move(columns);
+        generated = true;
+    });
+    (generated ? m_Misses : m_Hits).fetch_add(1, std::memory_order_relaxed);
+
+    return *region->tiles[tileIdx];
+}
+
+size_t TerrainRegionCache::regionCount() const
+{
+    std::shared_lock lock(m_Mutex);
+    return m_Regions.size();
+}
+
+std::shared_ptr<TerrainRegionCache::Region> TerrainRegionCache::acquireRegion(int regionX, int regionZ)
+{
+    uint64_t key = packChunkKey(regionX, regionZ);
+    uint64_t now = m_UseClock.fetch_add(1, std::memory_order_relaxed) + 1;
+    {
+        std::shared_lock lock(m_Mutex);
+        auto it = m_Regions.find(key);
+        if (it != m_Regions.end())
+        {
+            it->second->lastUse.store(now, std::memory_order_relaxed);
+            return it->second;
+        }
+    }
+
+    std::unique_lock lock(m_Mutex);
+    auto it = m_Regions.find(key);
+    if (it == m_Regions.end()) // another thread may have inserted it between the two locks
+    {
+        if (m_Regions.size() >= m_MaxRegions)
+            evictLeastRecentlyUsed();
+        it = m_Regions.emplace(key, std::make_shared<Region>()).first;
+    }
+    it->second->lastUse.store(now, std::memory_order_relaxed);
+    return it->second;
+}
+
+void TerrainRegionCache::evictLeastRecentlyUsed()
+{
+    // threads still reading an evicted region keep it alive through their shared_ptr
+    auto oldest = m_Regions.begin();
+    for (auto it = m_Regions.begin(); it != m_Regions.end(); it++)
+        if (it->second->lastUse.load(std::memory_order_relaxed) < oldest->second->lastUse.load(std::memory_order_relaxed))
+            oldest = it;
+    m_Regions.erase(oldest);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <glm/vec3.hpp>
+
+#include "Chunk.h"
+#include "Biome.h"
+
+// per-column terrain inputs of one chunk, everything block placement needs from noise
+struct TerrainColumns
+{
+    std::array<uint8_t, CHUNK_WIDTH * CHUNK_WIDTH> baseHeight; // stone up to (excluding) this y
+    std::array<uint8_t, CHUNK_WIDTH * CHUNK_WIDTH> biomeTopHeight; // thickness of the biome block layer on top
+    std::array<BiomeType, CHUNK_WIDTH * CHUNK_WIDTH> biome;
+};
+
+// caches TerrainColumns by region (REGION_WIDTH x REGION_WIDTH blocks), each chunk tile filled on first request
+// regions are evicted least-recently-used once more than maxRegions are cached
+// lookups only take a shared lock, so worker threads generating different chunks don't serialise on the cache
+class TerrainRegionCache {
+public:
+    static const int REGION_WIDTH = 512;
+    static const int REGION_CHUNKS = REGION_WIDTH / CHUNK_WIDTH; // chunks per region side
+
+    using ColumnGenerator = std::function<void(const glm::vec3& chunkPos, TerrainColumns& columns)>;
+
+    TerrainRegionCache(size_t maxRegions, ColumnGenerator generator);
+
+    // copy of the chunk's columns, generated (once, even under concurrent requests) on a miss
+    TerrainColumns columnsOf(const glm::vec3& chunkPos);
+
+    size_t regionCount() const;
+    uint64_t hitCount() const { return m_Hits.load(std::memory_order_relaxed); }
+    uint64_t missCount() const { return m_Misses.load(std::memory_order_relaxed); }
+
+private:
+    struct Region {
+        std::atomic<uint64_t> lastUse {0};
+        std::array<std::once_flag, REGION_CHUNKS * REGION_CHUNKS> filled;
+        std::array<std::unique_ptr<TerrainColumns>, REGION_CHUNKS * REGION_CHUNKS> tiles;
+    };
+
+    const size_t m_MaxRegions;
+    ColumnGenerator m_Generator;
+
+    mutable std::shared_mutex m_Mutex; // guards m_Regions, regions themselves are shared_ptr-owned
+    std::unordered_map<uint64_t, std::shared_ptr<Region>> m_Regions;
+    std::atomic<uint64_t> m_UseClock {0};
+    std::atomic<uint64_t> m_Hits {0};
+    std::atomic<uint64_t> m_Misses {0};
+
+    std::shared_ptr<Region> acquireRegion(int regionX, int regionZ);
+    void evictLeastRecentlyUsed(); // caller holds m_Mutex exclusively
+
+    static int floorDiv(int a, int b) {
+        return (a >= 0) ? a / b : -((-a + b - 1) / b);
+    }
+};
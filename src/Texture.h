@@ -29,17 +29,23 @@ private:
     std::string m_Path;
 };
 
+// 8 byte chunk mesh vertex, positions are chunk-local and offset by the chunkOrigin uniform in ArrayVertex.glsl
+// x, z: 0-16 (5 bits), y: 0-128 (8 bits), u, v: quad-size texture coords 0-128 (8 bits, texture repeats)
+// layer: texture array layer (BlockType), face: Direction of the quad (3 bits), light: sunlight | torchlight << 4
 struct texArrayVertex
 {
-    GLfloat xWorldPos; GLfloat yWorldPos; GLfloat zWorldPos;
-    GLfloat uTexCoord; GLfloat vTexCoord; GLfloat pictureNum;
-    GLubyte lightLevel;
-
-    texArrayVertex(GLfloat xPos, GLfloat yPos, GLfloat zPos,
-                   GLfloat uCoord, GLfloat vCoord, GLfloat picNum,
-                   GLubyte lightLevel)
-            : xWorldPos(xPos), yWorldPos(yPos), zWorldPos(zPos),
-              uTexCoord(uCoord), vTexCoord(vCoord), pictureNum(picNum),
-              lightLevel(lightLevel)
+    GLuint positionU; // x | y << 5 | z << 13 | u << 18 | face << 26
+    GLuint vLayerLight; // v | layer << 8 | light << 16
+
+    texArrayVertex(int x, int y, int z, int u, int v, int layer, int face, GLubyte lightLevel)
+            : positionU(static_cast<GLuint>(x | y << 5 | z << 13 | u << 18 | face << 26)),
+              vLayerLight(static_cast<GLuint>(v | layer << 8 | lightLevel << 16))
     {};
 };
+static_assert(sizeof(texArrayVertex) == 8, "chunk vertices are uploaded as two packed uints");
+
+// chunk meshes store 4 vertices per quad (start, start + width, start + height, end),
+// RenderSystem draws them through one shared index buffer repeating this pattern
+const int VERTICES_PER_QUAD = 4;
+const int INDICES_PER_QUAD = 6;
+const GLuint QUAD_INDEX_PATTERN[INDICES_PER_QUAD] = {0, 1, 2, 2, 3, 1};
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <entt/entt.hpp>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include "Components.h"
+
+// the world's TimeOfDayComponent (created by World alongside the player)
+inline TimeOfDayComponent& getTimeOfDay(entt::registry& registry)
+{
+    auto timeView = registry.view<TimeOfDayComponent>();
+    for (auto e_Time : timeView)
+        return timeView.get<TimeOfDayComponent>(e_Time);
+    throw std::runtime_error("[Runtime Exception] No TimeOfDayComponent in registry");
+}
+
+// 0 at night, 1 during the day; ramps while the sun is close to the horizon instead of following its height all day
+inline float daylightFactor(const TimeOfDayComponent& time)
+{
+    float sunHeight = -std::cos(2.0f * glm::pi<float>() * time.timeOfDay); // -1 midnight, 1 noon
+    return std::clamp(sunHeight * 4.0f + 0.5f, 0.0f, 1.0f);
+}
+
+// factor the block shader applies to sunlight, torchlight is unaffected
+inline float skyBrightness(const TimeOfDayComponent& time)
+{
+    const float nightSkyBrightness = 0.15f; // moonlight, keeps areas without torchlight readable
+    return nightSkyBrightness + (1.0f - nightSkyBrightness) * daylightFactor(time);
+}
+
+// clear color: the day sky fading to a dark blue night
+inline glm::vec3 skyColor(const TimeOfDayComponent& time)
+{
+    const glm::vec3 daySky(0.604f, 0.796f, 1.0f);
+    const glm::vec3 nightSky(0.02f, 0.03f, 0.08f);
+    return glm::mix(nightSky, daySky, daylightFactor(time));
+}
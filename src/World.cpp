@@ -1,14 +1,17 @@
 
 #include "World.h"
+#include "TimeOfDay.h"
 
 World::World()
 // must call createPlayer() before user camera can be passed to renderSystem & inputSystem
     : renderSystem((createPlayer(), retrievePlayerCamera())), registry(entt::registry()),
-      inputSystem(registry, renderSystem.get_window(), renderSystem.get_camera()),
-      chunkMeshingSystem(ChunkMeshingSystem()),
-      chunkLoaderSystem(registry, 5271998)
+      lightEngine(registry), inputSystem(registry, renderSystem.get_window(), renderSystem.get_camera(), lightEngine),
+      chunkMeshingSystem(jobSystem),
+      chunkLoaderSystem(registry, 5271998, jobSystem, lightEngine)
 {
     inputSystem.assign_window_callbacks();
+    createFrameBudget();
+    createTimeOfDay();
 
     // create 5x5 chunk grid for testing
 //    for (int x = 0; x <= 16*10; x+=16)
@@ -27,6 +30,7 @@ void World::update()
 
     // TODO: optimize order (e.g. delete unnecessary chunks before rendering)
     inputSystem.update(registry, deltaTime);
+    getTimeOfDay(registry).advance(deltaTime);
     chunkLoaderSystem.update(registry);
     chunkMeshingSystem.update(registry);
     renderSystem.update(registry);
@@ -43,6 +47,19 @@ void World::createPlayer() {
     // eventually add inventory component
 }
 
+void World::createFrameBudget()
+{
+    // default streaming budgets, systems read (and report into) this component every frame
+    entt::entity e_Budget = registry.create();
+    registry.emplace<FrameBudgetComponent>(e_Budget);
+}
+
+void World::createTimeOfDay()
+{
+    entt::entity e_Time = registry.create();
+    registry.emplace<TimeOfDayComponent>(e_Time);
+}
+
 std::shared_ptr<Camera> World::retrievePlayerCamera()
 {
     // there should only be one player with camera per game, so return first value found
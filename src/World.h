@@ -15,6 +15,8 @@
 #include "InputSystem.h"
 #include "ChunkLoaderSystem.h"
 #include "ChunkMeshingSystem.h"
+#include "JobSystem.h"
+#include "LightEngine.h"
 
 class Entity;
 
@@ -24,7 +26,9 @@ private:
     entt::registry registry;
 
     RenderSystem renderSystem;
+    LightEngine lightEngine; // incremental light, shared by chunk loading and block edits
     InputSystem inputSystem;
+    JobSystem jobSystem; // worker pool shared by chunk generation and meshing
     ChunkMeshingSystem chunkMeshingSystem;
     ChunkLoaderSystem chunkLoaderSystem;
 
@@ -41,5 +45,7 @@ public:
     void update();
     bool isDestroyed();
     void createPlayer();
+    void createFrameBudget();
+    void createTimeOfDay();
     std::shared_ptr<Camera> retrievePlayerCamera();
 };
\ No newline at end of file
@@ -0,0 +1,171 @@
+// headless world pre-generation: meincraft-pregen <seed> <radius> [outDir] [--verify]
+// generates and lights every chunk within radius (in chunks) of spawn on the job system
+// and writes them to 32x32 chunk region files <outDir>/r.<rx>.<rz>.chunks
+// stored light is chunk-local (each chunk lit on its own, nothing spills across borders);
+// whoever loads these records must stitch them with their neighbours (LightEngine::stitchChunk) like generated chunks
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/resource.h>
+#include <glm/vec2.hpp>
+
+#include "ChunkGenerator.h"
+#include "ChunkSerializer.h"
+#include "JobSystem.h"
+#include "MPSCQueue.h"
+
+namespace {
+
+const int REGION_CHUNKS = 32; // region files hold REGION_CHUNKS x REGION_CHUNKS chunks
+
+int floorDiv(int a, int b)
+{
+    return (a >= 0) ? a / b : -((-a + b - 1) / b);
+}
+
+std::filesystem::path regionPath(const std::filesystem::path& outDir, int chunkX, int chunkZ)
+{
+    int regionX = floorDiv(chunkX, REGION_CHUNKS);
+    int regionZ = floorDiv(chunkZ, REGION_CHUNKS);
+    return outDir / ("r." + std::to_string(regionX) + "." + std::to_string(regionZ) + ".chunks");
+}
+
+double peakRssMb()
+{
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0); // bytes on macOS
+#else
+    return usage.ru_maxrss / 1024.0; // kilobytes on Linux
+#endif
+}
+
+// reads every region file back and compares each chunk against a fresh generation
+bool verifyRegions(const std::filesystem::path& outDir, ChunkGenerator& generator, size_t expectedChunks)
+{
+    size_t chunksRead = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(outDir))
+    {
+        if (entry.path().extension() != ".chunks")
+            continue;
+        std::ifstream in(entry.path(), std::ios::binary);
+        ChunkPayload stored;
+        while (ChunkSerializer::readChunk(in, stored))
+        {
+            chunksRead++;
+            std::unique_ptr<ChunkPayload> fresh = generator.generateChunkData(stored.chunkPos);
+            bool sameBlocks = true;
+            for (int y = 0; y < CHUNK_HEIGHT && sameBlocks; y++)
+                for (int z = 0; z < CHUNK_WIDTH; z++)
+                    for (int x = 0; x < CHUNK_WIDTH; x++)
+                        sameBlocks = sameBlocks && stored.chunk.typeAt(x, y, z) == fresh->chunk.typeAt(x, y, z);
+            if (not sameBlocks || stored.chunk.lightMap != fresh->chunk.lightMap
+                || stored.chunk.biomeMap != fresh->chunk.biomeMap)
+            {
+                std::cerr << "mismatch in chunk (" << stored.chunkPos.x << ", " << stored.chunkPos.z << ") of "
+                          << entry.path() << std::endl;
+                return false;
+            }
+            stored = ChunkPayload();
+        }
+    }
+    if (chunksRead != expectedChunks)
+    {
+        std::cerr << "read " << chunksRead << " chunks, expected " << expectedChunks << std::endl;
+        return false;
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::string> args(argv + 1, argv + argc);
+    bool verify = std::find(args.begin(), args.end(), "--verify") != args.end();
+    args.erase(std::remove(args.begin(), args.end(), "--verify"), args.end());
+    if (args.size() < 2 || args.size() > 3)
+    {
+        std::cerr << "usage: meincraft-pregen <seed> <radius> [outDir] [--verify]" << std::endl;
+        return 1;
+    }
+    int seed = std::stoi(args[0]);
+    int radius = std::stoi(args[1]);
+    std::filesystem::path outDir = (args.size() == 3) ? args[2] : "world";
+    std::filesystem::create_directories(outDir);
+
+    // spawn first, then outward rings, the same order the loader prefers
+    std::vector<glm::ivec2> chunkCoords;
+    for (int z = -radius; z <= radius; z++)
+        for (int x = -radius; x <= radius; x++)
+            if (x * x + z * z <= radius * radius)
+                chunkCoords.emplace_back(x, z);
+    std::sort(chunkCoords.begin(), chunkCoords.end(), [](const glm::ivec2& a, const glm::ivec2& b) {
+        return a.x * a.x + a.y * a.y < b.x * b.x + b.y * b.y;
+    });
+
+    ChunkGenerator generator(seed);
+    JobSystem jobSystem;
+    MPSCQueue<std::unique_ptr<ChunkPayload>> completedChunks;
+    JobCounter jobs;
+
+    auto start = std::chrono::steady_clock::now();
+    for (const glm::ivec2& coord : chunkCoords)
+        jobSystem.submit([&generator, &completedChunks, coord]() {
+            glm::vec3 chunkPos(coord.x * CHUNK_WIDTH, 0, coord.y * CHUNK_WIDTH);
+            completedChunks.push(generator.generateChunkData(chunkPos));
+        }, &jobs);
+
+    // main thread owns the files: drain finished chunks and append them to their region
+    std::map<std::filesystem::path, std::ofstream> regionFiles;
+    size_t chunksWritten = 0;
+    uintmax_t bytesWritten = 0;
+    while (chunksWritten < chunkCoords.size())
+    {
+        std::unique_ptr<ChunkPayload> payload;
+        if (not completedChunks.tryPop(payload))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        int chunkX = static_cast<int>(payload->chunkPos.x) / CHUNK_WIDTH;
+        int chunkZ = static_cast<int>(payload->chunkPos.z) / CHUNK_WIDTH;
+        std::filesystem::path path = regionPath(outDir, chunkX, chunkZ);
+        auto [it, opened] = regionFiles.try_emplace(path);
+        if (opened)
+            it->second.open(path, std::ios::binary | std::ios::trunc);
+        if (not it->second)
+            throw std::runtime_error("[Runtime Exception] Failed to write region file " + path.string());
+        ChunkSerializer::writeChunk(it->second, *payload);
+        chunksWritten++;
+    }
+    jobSystem.wait(jobs);
+    for (auto& [path, file] : regionFiles)
+    {
+        file.close();
+        bytesWritten += std::filesystem::file_size(path);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "generated " << chunksWritten << " chunks in " << seconds << " s ("
+              << chunksWritten / seconds << " chunks/s, " << jobSystem.workerCount() << " workers)" << std::endl;
+    std::cout << "wrote " << bytesWritten / 1024 << " KiB to " << regionFiles.size() << " region files in "
+              << outDir << " (" << bytesWritten / std::max<size_t>(chunksWritten, 1) << " bytes/chunk)" << std::endl;
+    std::cout << "peak RSS " << peakRssMb() << " MiB" << std::endl;
+
+    if (verify)
+    {
+        bool ok = verifyRegions(outDir, generator, chunksWritten);
+        std::cout << "verify: " << (ok ? "ok" : "FAILED") << std::endl;
+        return ok ? 0 : 1;
+    }
+    return 0;
+}